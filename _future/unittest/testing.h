@@ -4,6 +4,7 @@
 #define testingprivIncludeGuard_testing_h
 
 #include <stdarg.h>
+#include <stddef.h>
 
 #undef testingprivBadLanguageVersion
 #ifdef __cplusplus
@@ -71,7 +72,17 @@ extern "C" {
 	testingprivMkCtor(Test ## Name, testingprivRegisterTest) \
 	void Test ## Name(testingT *t)
 
+// benchmarks can't fail, so they don't need the exception scaffolding
+#define testingBenchmark(Name) \
+	void Benchmark ## Name(testingB *b); \
+	static inline void testingprivScaffoldBenchmark ## Name(testingB *b) { Benchmark ## Name(b); } \
+	testingprivMkCtor(Benchmark ## Name, testingprivRegisterBenchmark) \
+	void Benchmark ## Name(testingB *b)
+
 extern int testingMain(void);
+// testingBenchmarkMain() runs all benchmarks whose names contain the -bench=substring argument, if any.
+// Other arguments: -benchtime=seconds (default 1) is how long to run each benchmark for; -maxsize=n caps testingBRunSizes().
+extern int testingBenchmarkMain(int argc, char *argv[]);
 
 typedef struct testingT testingT;
 #define testingTLogf(t, ...) \
@@ -101,6 +112,27 @@ extern void testingTFail(testingT *t);
 // TODO should the defered function also have t passed to it?
 extern void testingTDefer(testingT *t, void (*f)(void *data), void *data);
 
+typedef struct testingB testingB;
+// testingBN() is the number of times the benchmark should do its operation.
+extern int testingBN(testingB *b);
+extern void testingBStartTimer(testingB *b);
+extern void testingBStopTimer(testingB *b);
+extern void testingBResetTimer(testingB *b);
+// testingBRunSizes() runs f as a sub-benchmark for each power of 10 from minSize to maxSize inclusive.
+// f should do its operation testingBN(b) times on an input of the given size.
+typedef void (*testingBSizeFunc)(testingB *b, size_t size, void *data);
+extern void testingBRunSizes(testingB *b, size_t minSize, size_t maxSize, testingBSizeFunc f, void *data);
+
+// the code being benchmarked can report its memory use through this; it is read whenever the timer starts and stops
+typedef struct testingMemoryStats testingMemoryStats;
+struct testingMemoryStats {
+	unsigned long long Allocs;		// total number of allocations ever made
+	unsigned long long Bytes;		// total number of bytes ever allocated
+	unsigned long long Live;		// number of bytes currently allocated
+	unsigned long long Peak;		// most bytes live at once since the last call to resetPeak
+};
+extern void testingSetMemoryHook(void (*read)(testingMemoryStats *s), void (*resetPeak)(void));
+
 // TODO IEEE 754 helpers
 // references:
 // - https://www.sourceware.org/ml/libc-alpha/2009-04/msg00005.html
@@ -109,6 +141,7 @@ extern void testingTDefer(testingT *t, void (*f)(void *data), void *data);
 
 // TODO should __LINE__ arguments use intmax_t or uintmax_t instead of int?
 extern void testingprivRegisterTest(const char *, void (*)(testingT *));
+extern void testingprivRegisterBenchmark(const char *, void (*)(testingB *));
 // see https://stackoverflow.com/questions/32399191/va-args-expansion-using-msvc
 #define testingprivExpand(x) x
 #define testingprivTLogfThen(then, t, ...) ((testingprivTLogfFull(t, __FILE__, __LINE__, __VA_ARGS__)), (then(t)))
@@ -127,6 +160,10 @@ namespace {
 	public:
 		testingprivRegisterTestClass(const char *name, void (*f)(testingT *)) { testingprivRegisterTest(name, f); }
 	};
+	class testingprivRegisterBenchmarkClass {
+	public:
+		testingprivRegisterBenchmarkClass(const char *name, void (*f)(testingB *)) { testingprivRegisterBenchmark(name, f); }
+	};
 }
 #endif
 
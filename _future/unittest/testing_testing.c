@@ -1,7 +1,18 @@
 // 27 february 2018
+// for clock_gettime()
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <setjmp.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
 #include "testing.h"
 
 #define testingprivNew(T) ((T *) malloc(sizeof (T)))
@@ -142,3 +153,229 @@ void testingTDefer(testingT *t, void (*f)(void *data), void *data)
 	d->next = t->defers;
 	t->defers = d;
 }
+
+struct testingB {
+	const char *name;
+	void (*f)(testingB *);
+	testingB *next;
+
+	// for the current run
+	int n;
+	int timerOn;
+	uint64_t start;
+	uint64_t elapsed;
+	testingMemoryStats startMem;
+	unsigned long long allocs;
+	unsigned long long bytes;
+	unsigned long long peak;
+	int hasSub;
+};
+
+static testingB *benchmarks = NULL;
+static testingB **benchmarksTail = &benchmarks;
+
+static uint64_t benchTime = 1000000000;
+static size_t benchMaxSize = (size_t) (-1);
+
+static void (*memRead)(testingMemoryStats *s) = NULL;
+static void (*memResetPeak)(void) = NULL;
+
+void testingprivRegisterBenchmark(const char *name, void (*f)(testingB *))
+{
+	testingB *b;
+
+	b = testingprivNew(testingB);
+	memset(b, 0, sizeof (testingB));
+	b->name = name;
+	b->f = f;
+	// unlike tests, keep these in the order registered so related benchmarks in a file stay together
+	*benchmarksTail = b;
+	benchmarksTail = &(b->next);
+}
+
+void testingSetMemoryHook(void (*read)(testingMemoryStats *s), void (*resetPeak)(void))
+{
+	memRead = read;
+	memResetPeak = resetPeak;
+}
+
+static uint64_t nanotime(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER count, freq;
+
+	QueryPerformanceCounter(&count);
+	QueryPerformanceFrequency(&freq);
+	return (uint64_t) ((double) count.QuadPart * 1e9 / (double) freq.QuadPart);
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+int testingBN(testingB *b)
+{
+	return b->n;
+}
+
+void testingBStartTimer(testingB *b)
+{
+	if (b->timerOn)
+		return;
+	b->timerOn = 1;
+	if (memRead != NULL)
+		(*memRead)(&(b->startMem));
+	b->start = nanotime();
+}
+
+void testingBStopTimer(testingB *b)
+{
+	testingMemoryStats m;
+
+	if (!b->timerOn)
+		return;
+	b->elapsed += nanotime() - b->start;
+	if (memRead != NULL) {
+		(*memRead)(&m);
+		b->allocs += m.Allocs - b->startMem.Allocs;
+		b->bytes += m.Bytes - b->startMem.Bytes;
+		if (m.Peak > b->startMem.Live && b->peak < m.Peak - b->startMem.Live)
+			b->peak = m.Peak - b->startMem.Live;
+	}
+	b->timerOn = 0;
+}
+
+void testingBResetTimer(testingB *b)
+{
+	if (b->timerOn) {
+		if (memRead != NULL)
+			(*memRead)(&(b->startMem));
+		b->start = nanotime();
+	}
+	b->elapsed = 0;
+	b->allocs = 0;
+	b->bytes = 0;
+	b->peak = 0;
+	if (memResetPeak != NULL)
+		(*memResetPeak)();
+}
+
+struct benchFunc {
+	void (*f)(testingB *);
+	testingBSizeFunc sized;
+	size_t size;
+	void *data;
+};
+
+static void runN(testingB *b, struct benchFunc *bf, int n)
+{
+	b->n = n;
+	b->hasSub = 0;
+	b->timerOn = 0;
+	testingBResetTimer(b);
+	testingBStartTimer(b);
+	if (bf->sized != NULL)
+		(*(bf->sized))(b, bf->size, bf->data);
+	else
+		(*(bf->f))(b);
+	testingBStopTimer(b);
+}
+
+// this is the same approach as Go: keep growing n, predicting how many iterations will fill benchTime, until it does
+static void runBenchmark(testingB *b, struct benchFunc *bf)
+{
+	int n, prev;
+	uint64_t perOp;
+
+	n = 1;
+	runN(b, bf, n);
+	if (b->hasSub)
+		// this was just a parent for testingBRunSizes(); its children have already been reported
+		return;
+	while (b->elapsed < benchTime && n < 1000000000) {
+		prev = n;
+		perOp = b->elapsed / n;
+		if (perOp == 0)
+			perOp = 1;
+		n = (int) ((benchTime + benchTime / 5) / perOp);
+		if (n > 100 * prev)
+			n = 100 * prev;
+		if (n <= prev)
+			n = prev + 1;
+		if (n > 1000000000)
+			n = 1000000000;
+		runN(b, bf, n);
+	}
+
+	printf("%-48s %10d %14.1f ns/op", b->name, b->n, (double) (b->elapsed) / b->n);
+	if (memRead != NULL)
+		printf(" %12.0f B/op %10.1f allocs/op %12llu peak-B",
+			(double) (b->bytes) / b->n,
+			(double) (b->allocs) / b->n,
+			b->peak);
+	printf("\n");
+	fflush(stdout);
+}
+
+void testingBRunSizes(testingB *b, size_t minSize, size_t maxSize, testingBSizeFunc f, void *data)
+{
+	testingB sub;
+	struct benchFunc bf;
+	char name[256];
+	size_t size;
+
+	b->hasSub = 1;
+	// the parent's own timing is meaningless
+	testingBStopTimer(b);
+	if (maxSize > benchMaxSize)
+		maxSize = benchMaxSize;
+	for (size = minSize; size <= maxSize; size *= 10) {
+		memset(&sub, 0, sizeof (testingB));
+		snprintf(name, sizeof (name), "%s/%lu", b->name, (unsigned long) size);
+		sub.name = name;
+		bf.f = NULL;
+		bf.sized = f;
+		bf.size = size;
+		bf.data = data;
+		runBenchmark(&sub, &bf);
+		if (size > ((size_t) (-1)) / 10)
+			break;
+	}
+}
+
+int testingBenchmarkMain(int argc, char *argv[])
+{
+	const char *filter = NULL;
+	struct benchFunc bf;
+	testingB *b;
+	int i;
+
+	for (i = 1; i < argc; i++)
+		if (strncmp(argv[i], "-bench=", 7) == 0)
+			filter = argv[i] + 7;
+		else if (strncmp(argv[i], "-benchtime=", 11) == 0)
+			benchTime = (uint64_t) (strtod(argv[i] + 11, NULL) * 1e9);
+		else if (strncmp(argv[i], "-maxsize=", 9) == 0)
+			benchMaxSize = (size_t) strtod(argv[i] + 9, NULL);
+		else {
+			fprintf(stderr, "usage: %s [-bench=substring] [-benchtime=seconds] [-maxsize=n]\n", argv[0]);
+			return 2;
+		}
+
+	if (benchmarks == NULL) {
+		fprintf(stderr, "warning: no benchmarks to run\n");
+		return 0;
+	}
+	for (b = benchmarks; b != NULL; b = b->next) {
+		if (filter != NULL && strstr(b->name, filter) == NULL)
+			continue;
+		bf.f = b->f;
+		bf.sized = NULL;
+		bf.size = 0;
+		bf.data = NULL;
+		runBenchmark(b, &bf);
+	}
+	return 0;
+}
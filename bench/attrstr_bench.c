@@ -0,0 +1,227 @@
+// 19 october 2026
+#include "bench.h"
+
+// the attribute list is a linked list with linear-time insertion, so building one is quadratic; keep these sizes where a run still finishes in seconds
+#define maxAttrSize 100000
+// inserting in the middle moves the rest of the string every time
+#define maxInsertSize 100000
+
+// 17 bytes, with some multibyte characters so the UTF-16 tables have something to do
+static const char chunk[] = "abc d\xC3\xA9" "f gh\xE2\x82\xAC" "ij ";
+#define chunkLen (sizeof (chunk) - 1)
+
+// every attribute spans this many bytes
+#define attrLen 8
+
+static uiAttributedString *newASCIIString(size_t size)
+{
+	char *buf;
+	uiAttributedString *s;
+
+	buf = (char *) malloc(size + 1);
+	memset(buf, 'a', size);
+	buf[size] = '\0';
+	s = uiNewAttributedString(buf);
+	free(buf);
+	return s;
+}
+
+// alternate between two colors so neighboring attributes don't merge
+static uiAttribute *nthAttribute(size_t i)
+{
+	if ((i % 2) == 0)
+		return uiNewColorAttribute(1, 0, 0, 1);
+	return uiNewColorAttribute(0, 0, 1, 1);
+}
+
+static void setAttributes(uiAttributedString *s, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i + attrLen <= size; i += attrLen)
+		uiAttributedStringSetAttribute(s, nthAttribute(i / attrLen), i, i + attrLen);
+}
+
+static void benchAppend(testingB *b, size_t size, void *data)
+{
+	uiAttributedString *s;
+	int i;
+
+	for (i = 0; i < testingBN(b); i++) {
+		s = uiNewAttributedString("");
+		while (uiAttributedStringLen(s) < size)
+			uiAttributedStringAppendUnattributed(s, chunk);
+		uiFreeAttributedString(s);
+	}
+}
+
+testingBenchmark(AttributedStringAppend)
+{
+	testingBRunSizes(b, 1000, 10000000, benchAppend, NULL);
+}
+
+static void benchInsert(testingB *b, size_t size, void *data)
+{
+	uiAttributedString *s;
+	int i;
+
+	for (i = 0; i < testingBN(b); i++) {
+		s = uiNewAttributedString("");
+		while (uiAttributedStringLen(s) < size)
+			// stay on a chunk boundary so we never insert in the middle of a character
+			uiAttributedStringInsertAtUnattributed(s, chunk,
+				(uiAttributedStringLen(s) / chunkLen / 2) * chunkLen);
+		uiFreeAttributedString(s);
+	}
+}
+
+testingBenchmark(AttributedStringInsert)
+{
+	testingBRunSizes(b, 1000, maxInsertSize, benchInsert, NULL);
+}
+
+static void benchSetAttribute(testingB *b, size_t size, void *data)
+{
+	uiAttributedString *s;
+	int i;
+
+	for (i = 0; i < testingBN(b); i++) {
+		testingBStopTimer(b);
+		s = newASCIIString(size);
+		testingBStartTimer(b);
+		setAttributes(s, size);
+		testingBStopTimer(b);
+		uiFreeAttributedString(s);
+		testingBStartTimer(b);
+	}
+}
+
+testingBenchmark(AttributedStringSetAttribute)
+{
+	testingBRunSizes(b, 1000, maxAttrSize, benchSetAttribute, NULL);
+}
+
+static void benchSetAttributesBulk(testingB *b, size_t size, void *data)
+{
+	uiAttributedString *s;
+	uiAttributeRun *runs;
+	size_t j, n;
+	int i;
+
+	runs = (uiAttributeRun *) malloc((size / attrLen + 1) * sizeof (uiAttributeRun));
+	for (i = 0; i < testingBN(b); i++) {
+		testingBStopTimer(b);
+		s = newASCIIString(size);
+		// this includes making the attributes, like benchSetAttribute() does; all but two of them get merged away
+		testingBStartTimer(b);
+		n = 0;
+		for (j = 0; j + attrLen <= size; j += attrLen) {
+			runs[n].Attribute = nthAttribute(j / attrLen);
+			runs[n].Start = j;
+			runs[n].End = j + attrLen;
+			n++;
+		}
+		uiAttributedStringSetAttributesBulk(s, runs, n);
+		testingBStopTimer(b);
+		uiFreeAttributedString(s);
+		testingBStartTimer(b);
+	}
+	free(runs);
+}
+
+testingBenchmark(AttributedStringSetAttributesBulk)
+{
+	testingBRunSizes(b, 1000, 10000000, benchSetAttributesBulk, NULL);
+}
+
+static void benchRemoveAttribute(testingB *b, size_t size, void *data)
+{
+	uiprivAttrList *alist;
+	size_t j;
+	int i;
+
+	for (i = 0; i < testingBN(b); i++) {
+		testingBStopTimer(b);
+		alist = uiprivNewAttrList();
+		for (j = 0; j + attrLen <= size; j += attrLen)
+			uiprivAttrListInsertAttribute(alist, nthAttribute(j / attrLen), j, j + attrLen);
+		testingBStartTimer(b);
+		// remove from the middle of every other attribute, so every removal splits one apart
+		for (j = 0; j + attrLen <= size; j += 2 * attrLen)
+			uiprivAttrListRemoveAttribute(alist, uiAttributeTypeColor, j + 2, j + attrLen - 2);
+		testingBStopTimer(b);
+		uiprivFreeAttrList(alist);
+		testingBStartTimer(b);
+	}
+}
+
+testingBenchmark(AttrListRemoveAttribute)
+{
+	testingBRunSizes(b, 1000, maxAttrSize, benchRemoveAttribute, NULL);
+}
+
+static uiForEach countAttribute(const uiAttributedString *s, const uiAttribute *a, size_t start, size_t end, void *data)
+{
+	size_t *n = (size_t *) data;
+
+	(*n)++;
+	return uiForEachContinue;
+}
+
+static void benchForEach(testingB *b, size_t size, void *data)
+{
+	uiAttributedString *s;
+	size_t n;
+	int i;
+
+	testingBStopTimer(b);
+	s = newASCIIString(size);
+	setAttributes(s, size);
+	testingBStartTimer(b);
+	for (i = 0; i < testingBN(b); i++) {
+		n = 0;
+		uiAttributedStringForEachAttribute(s, countAttribute, &n);
+		if (n != size / attrLen) {
+			fprintf(stderr, "ForEachAttribute visited %lu attributes; expected %lu\n", (unsigned long) n, (unsigned long) (size / attrLen));
+			abort();
+		}
+	}
+	testingBStopTimer(b);
+	uiFreeAttributedString(s);
+}
+
+testingBenchmark(AttributedStringForEachAttribute)
+{
+	testingBRunSizes(b, 1000, maxAttrSize, benchForEach, NULL);
+}
+
+static void benchAttributesAt(testingB *b, size_t size, void *data)
+{
+	uiAttributedString *s;
+	size_t j, n;
+	int i;
+
+	testingBStopTimer(b);
+	s = newASCIIString(size);
+	setAttributes(s, size);
+	// build the index outside the timer; what this measures is the lookups
+	uiAttributedStringAttributesAt(s, 0, countAttribute, &n);
+	testingBStartTimer(b);
+	// one op is looking up every attribute once, like moving a cursor through the whole string
+	for (i = 0; i < testingBN(b); i++)
+		for (j = 0; j + attrLen <= size; j += attrLen) {
+			n = 0;
+			uiAttributedStringAttributesAt(s, j + attrLen / 2, countAttribute, &n);
+			if (n != 1) {
+				fprintf(stderr, "AttributesAt(%lu) visited %lu attributes; expected 1\n", (unsigned long) (j + attrLen / 2), (unsigned long) n);
+				abort();
+			}
+		}
+	testingBStopTimer(b);
+	uiFreeAttributedString(s);
+}
+
+testingBenchmark(AttributedStringAttributesAt)
+{
+	testingBRunSizes(b, 1000, maxAttrSize, benchAttributesAt, NULL);
+}
@@ -0,0 +1,14 @@
+// 19 october 2026
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "../ui.h"
+#include "uipriv.h"
+#include "attrstr.h"
+#include "testing.h"
+
+// shim.c
+extern void benchReadMemory(testingMemoryStats *s);
+extern void benchResetPeak(void);
@@ -0,0 +1,67 @@
+// 19 october 2026
+#include "bench.h"
+
+// a random walk, like a noisy time series, squeezed into a 2000-pixel-wide chart
+#define chartWidth 2000
+
+static double *xs = NULL;
+static double *ys = NULL;
+static size_t *indices = NULL;
+static size_t nPoints = 0;
+
+static void mkSeries(size_t size)
+{
+	size_t j;
+	double y;
+	uint32_t r;
+
+	if (nPoints >= size)
+		return;
+	free(xs);
+	free(ys);
+	free(indices);
+	xs = (double *) malloc(size * sizeof (double));
+	ys = (double *) malloc(size * sizeof (double));
+	indices = (size_t *) malloc(size * sizeof (size_t));
+	if (xs == NULL || ys == NULL || indices == NULL) {
+		fprintf(stderr, "memory exhausted making series\n");
+		abort();
+	}
+	y = 0;
+	r = 1;
+	for (j = 0; j < size; j++) {
+		// xorshift, so runs are repeatable
+		r ^= r << 13;
+		r ^= r >> 17;
+		r ^= r << 5;
+		y += ((double) (r % 2001) - 1000) / 1000;
+		xs[j] = (double) j;
+		ys[j] = y;
+	}
+	nPoints = size;
+}
+
+static void benchDecimate(testingB *b, size_t size, void *data)
+{
+	uiDrawMatrix m;
+	size_t n;
+	int i;
+
+	testingBStopTimer(b);
+	mkSeries(size);
+	uiDrawMatrixSetIdentity(&m);
+	// scale about the origin; set directly so this doesn't depend on an OS matrix implementation
+	m.M11 = (double) chartWidth / (double) size;
+	testingBStartTimer(b);
+	n = 0;
+	for (i = 0; i < testingBN(b); i++)
+		n += uiDrawDecimatePolyline(xs, ys, size, &m, indices);
+	testingBStopTimer(b);
+	if (n == 0)
+		printf("%lu\n", (unsigned long) n);
+}
+
+testingBenchmark(DrawDecimatePolyline)
+{
+	testingBRunSizes(b, 1000, 10000000, benchDecimate, NULL);
+}
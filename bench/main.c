@@ -0,0 +1,12 @@
+// 19 october 2026
+#include "bench.h"
+
+// The benchmarks compile the common/ sources directly against the stand-ins in shim.c instead of linking libui, so they don't need an OS backend or a display, and so every uiprivAlloc() can be counted.
+// The uiDrawMatrix benchmarks are the exception: they link the GTK+ backend's unix/drawmatrix.c, so they're only built where GTK+ is available.
+// Usage: bench [-bench=substring] [-benchtime=seconds] [-maxsize=n]
+
+int main(int argc, char *argv[])
+{
+	testingSetMemoryHook(benchReadMemory, benchResetPeak);
+	return testingBenchmarkMain(argc, argv);
+}
@@ -0,0 +1,89 @@
+// 19 october 2026
+#include "bench.h"
+
+// this is only built along with the GTK+ backend's unix/drawmatrix.c (see CMakeLists.txt), so what it measures is cairo_matrix_* and the conversions to and from uiDrawMatrix
+
+static void benchBuild(testingB *b, size_t size, void *data)
+{
+	uiDrawMatrix m;
+	double sum;
+	size_t j;
+	int i;
+
+	sum = 0;
+	// one op builds size transforms like a chart would for each of its elements
+	for (i = 0; i < testingBN(b); i++)
+		for (j = 0; j < size; j++) {
+			uiDrawMatrixSetIdentity(&m);
+			uiDrawMatrixTranslate(&m, (double) j, 10);
+			uiDrawMatrixScale(&m, 5, 5, 2, 0.5);
+			uiDrawMatrixRotate(&m, 5, 5, 0.25);
+			uiDrawMatrixSkew(&m, 5, 5, 0.1, 0);
+			sum += m.M31;
+		}
+	if (sum == -1)
+		printf("%g\n", sum);
+}
+
+testingBenchmark(DrawMatrixBuild)
+{
+	testingBRunSizes(b, 1000, 10000000, benchBuild, NULL);
+}
+
+static void benchTransform(testingB *b, size_t size, void *data)
+{
+	uiDrawMatrix m;
+	double x, y, sum;
+	size_t j;
+	int i;
+
+	uiDrawMatrixSetIdentity(&m);
+	uiDrawMatrixScale(&m, 0, 0, 2, 3);
+	uiDrawMatrixRotate(&m, 0, 0, 0.5);
+	uiDrawMatrixTranslate(&m, 10, 20);
+	sum = 0;
+	for (i = 0; i < testingBN(b); i++)
+		for (j = 0; j < size; j++) {
+			x = (double) j;
+			y = (double) (j / 2);
+			uiDrawMatrixTransformPoint(&m, &x, &y);
+			sum += x + y;
+			x = 1;
+			y = 1;
+			uiDrawMatrixTransformSize(&m, &x, &y);
+			sum += x + y;
+		}
+	if (sum == -1)
+		printf("%g\n", sum);
+}
+
+testingBenchmark(DrawMatrixTransform)
+{
+	testingBRunSizes(b, 1000, 10000000, benchTransform, NULL);
+}
+
+static void benchMultiplyInvert(testingB *b, size_t size, void *data)
+{
+	uiDrawMatrix m, n;
+	size_t j;
+	int i, ok;
+
+	uiDrawMatrixSetIdentity(&n);
+	uiDrawMatrixRotate(&n, 1, 1, 0.01);
+	ok = 0;
+	for (i = 0; i < testingBN(b); i++) {
+		uiDrawMatrixSetIdentity(&m);
+		for (j = 0; j < size; j++) {
+			uiDrawMatrixMultiply(&m, &n);
+			ok += uiDrawMatrixInvertible(&m);
+		}
+		ok += uiDrawMatrixInvert(&m);
+	}
+	if (ok == -1)
+		printf("%d\n", ok);
+}
+
+testingBenchmark(DrawMatrixMultiplyInvert)
+{
+	testingBRunSizes(b, 1000, 10000000, benchMultiplyInvert, NULL);
+}
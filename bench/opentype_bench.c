@@ -0,0 +1,108 @@
+// 19 october 2026
+#include "bench.h"
+
+// there are only 26^4 distinct tags from nthTag()
+#define maxFeatures 100000
+
+// tag i in base 26, so every i gets a distinct tag
+static void nthTag(size_t i, char tag[4])
+{
+	int j;
+
+	for (j = 3; j >= 0; j--) {
+		tag[j] = 'a' + (i % 26);
+		i /= 26;
+	}
+}
+
+static uiOpenTypeFeatures *mkFeatures(size_t size)
+{
+	uiOpenTypeFeatures *otf;
+	char tag[4];
+	size_t j;
+
+	otf = uiNewOpenTypeFeatures();
+	// add in a scrambled order so the set isn't always appended to at the end
+	for (j = 0; j < size; j++) {
+		nthTag((j * 7919) % size, tag);
+		uiOpenTypeFeaturesAdd(otf, tag[0], tag[1], tag[2], tag[3], (uint32_t) j);
+	}
+	return otf;
+}
+
+static void benchAdd(testingB *b, size_t size, void *data)
+{
+	uiOpenTypeFeatures *otf;
+	int i;
+
+	for (i = 0; i < testingBN(b); i++) {
+		otf = mkFeatures(size);
+		testingBStopTimer(b);
+		uiFreeOpenTypeFeatures(otf);
+		testingBStartTimer(b);
+	}
+}
+
+testingBenchmark(OpenTypeFeaturesAdd)
+{
+	testingBRunSizes(b, 10, maxFeatures, benchAdd, NULL);
+}
+
+static void benchGet(testingB *b, size_t size, void *data)
+{
+	uiOpenTypeFeatures *otf;
+	char tag[4];
+	uint32_t value, sum;
+	size_t j;
+	int i;
+
+	testingBStopTimer(b);
+	otf = mkFeatures(size);
+	testingBStartTimer(b);
+	sum = 0;
+	// one op is one lookup of every tag in the set
+	for (i = 0; i < testingBN(b); i++)
+		for (j = 0; j < size; j++) {
+			nthTag(j, tag);
+			if (uiOpenTypeFeaturesGet(otf, tag[0], tag[1], tag[2], tag[3], &value))
+				sum += value;
+		}
+	testingBStopTimer(b);
+	if (sum == 0xFFFFFFFF)
+		printf("%lu\n", (unsigned long) sum);
+	uiFreeOpenTypeFeatures(otf);
+}
+
+testingBenchmark(OpenTypeFeaturesGet)
+{
+	testingBRunSizes(b, 10, maxFeatures, benchGet, NULL);
+}
+
+static uiForEach countFeature(const uiOpenTypeFeatures *otf, char a, char b, char c, char d, uint32_t value, void *data)
+{
+	size_t *n = (size_t *) data;
+
+	(*n)++;
+	return uiForEachContinue;
+}
+
+static void benchForEach(testingB *b, size_t size, void *data)
+{
+	uiOpenTypeFeatures *otf;
+	size_t n;
+	int i;
+
+	testingBStopTimer(b);
+	otf = mkFeatures(size);
+	testingBStartTimer(b);
+	n = 0;
+	for (i = 0; i < testingBN(b); i++)
+		uiOpenTypeFeaturesForEach(otf, countFeature, &n);
+	testingBStopTimer(b);
+	uiFreeOpenTypeFeatures(otf);
+}
+
+testingBenchmark(OpenTypeFeaturesForEach)
+{
+	testingBRunSizes(b, 10, maxFeatures, benchForEach, NULL);
+}
@@ -0,0 +1,185 @@
+// 19 october 2026
+#include "bench.h"
+
+// These stand in for the OS-specific parts of libui that the common/ code calls into.
+// They should stay as cheap as the real ones, or the benchmarks will measure the shims instead of libui.
+
+uiInitOptions uiprivOptions;
+
+// like the real allocators, keep the size in front of each block, but count instead of tracking every block
+#define EXTRA 16
+#define BASE(p) ((void *) (((uint8_t *) (p)) - EXTRA))
+#define DATA(p) ((void *) (((uint8_t *) (p)) + EXTRA))
+#define SIZE(p) (*((size_t *) (p)))
+
+static testingMemoryStats stats;
+
+static void countAlloc(size_t size)
+{
+	stats.Allocs++;
+	stats.Bytes += size;
+	stats.Live += size;
+	if (stats.Peak < stats.Live)
+		stats.Peak = stats.Live;
+}
+
+void *uiprivAlloc(size_t size, const char *type)
+{
+	void *out;
+
+	out = calloc(1, EXTRA + size);
+	if (out == NULL) {
+		fprintf(stderr, "memory exhausted allocating %s\n", type);
+		abort();
+	}
+	SIZE(out) = size;
+	countAlloc(size);
+	return DATA(out);
+}
+
+void *uiprivRealloc(void *p, size_t new, const char *type)
+{
+	void *out;
+	size_t old;
+
+	if (p == NULL)
+		return uiprivAlloc(new, type);
+	p = BASE(p);
+	old = SIZE(p);
+	out = realloc(p, EXTRA + new);
+	if (out == NULL) {
+		fprintf(stderr, "memory exhausted reallocating %s\n", type);
+		abort();
+	}
+	if (new > old)
+		memset(((uint8_t *) DATA(out)) + old, 0, new - old);
+	SIZE(out) = new;
+	stats.Live -= old;
+	countAlloc(new);
+	return DATA(out);
+}
+
+void uiprivFree(void *p)
+{
+	if (p == NULL)
+		uiprivImplBug("attempt to uiprivFree(NULL)");
+	p = BASE(p);
+	stats.Live -= SIZE(p);
+	free(p);
+}
+
+void benchReadMemory(testingMemoryStats *s)
+{
+	*s = stats;
+}
+
+void benchResetPeak(void)
+{
+	stats.Peak = stats.Live;
+}
+
+void uiprivRealBug(const char *file, const char *line, const char *func, const char *prefix, const char *format, va_list ap)
+{
+	fprintf(stderr, "[libui] %s:%s:%s() %s", file, line, func, prefix);
+	vfprintf(stderr, format, ap);
+	fprintf(stderr, "\n");
+	abort();
+}
+
+int uiprivStricmp(const char *a, const char *b)
+{
+	int ca, cb;
+
+	for (;; a++, b++) {
+		ca = (unsigned char) *a;
+		cb = (unsigned char) *b;
+		if (ca >= 'A' && ca <= 'Z')
+			ca += 'a' - 'A';
+		if (cb >= 'A' && cb <= 'Z')
+			cb += 'a' - 'A';
+		if (ca != cb)
+			return ca - cb;
+		if (ca == '\0')
+			return 0;
+	}
+}
+
+// without a real text engine, treat every code point as its own grapheme
+int uiprivGraphemesTakesUTF16(void)
+{
+	return 0;
+}
+
+uiprivGraphemes *uiprivNewGraphemes(void *s, size_t len)
+{
+	uiprivGraphemes *g;
+	const char *text = (const char *) s;
+	const char *p;
+	uint32_t rune;
+	size_t i;
+
+	g = uiprivNew(uiprivGraphemes);
+	g->len = uiprivUTF8RuneCount(text, len);
+	g->pointsToGraphemes = (size_t *) uiprivAlloc((len + 1) * sizeof (size_t), "size_t[] (graphemes)");
+	g->graphemesToPoints = (size_t *) uiprivAlloc((g->len + 1) * sizeof (size_t), "size_t[] (graphemes)");
+	p = text;
+	for (i = 0; i < g->len; i++) {
+		size_t start, end, j;
+
+		start = p - text;
+		p = uiprivUTF8DecodeRune(p, 0, &rune);
+		end = p - text;
+		g->graphemesToPoints[i] = start;
+		for (j = start; j < end; j++)
+			g->pointsToGraphemes[j] = i;
+	}
+	g->graphemesToPoints[i] = len;
+	g->pointsToGraphemes[len] = i;
+	return g;
+}
+
+#ifndef benchNativeMatrix
+
+// without GTK+ there's no unix/drawmatrix.c to link, so the matrix benchmarks aren't built
+// common/matrix.c still needs these two for its fallbacks, though; nothing times them
+void uiDrawMatrixMultiply(uiDrawMatrix *dest, uiDrawMatrix *src)
+{
+	uiDrawMatrix t;
+
+	t.M11 = dest->M11 * src->M11 + dest->M12 * src->M21;
+	t.M12 = dest->M11 * src->M12 + dest->M12 * src->M22;
+	t.M21 = dest->M21 * src->M11 + dest->M22 * src->M21;
+	t.M22 = dest->M21 * src->M12 + dest->M22 * src->M22;
+	t.M31 = dest->M31 * src->M11 + dest->M32 * src->M21 + src->M31;
+	t.M32 = dest->M31 * src->M12 + dest->M32 * src->M22 + src->M32;
+	*dest = t;
+}
+
+void uiDrawMatrixTransformPoint(uiDrawMatrix *m, double *x, double *y)
+{
+	double xt;
+
+	xt = *x;
+	*x = m->M11 * xt + m->M21 * *y + m->M31;
+	*y = m->M12 * xt + m->M22 * *y + m->M32;
+}
+
+#endif
+
+// the OS-specific versions spread this across threads; running it serially here measures the per-thread cost of whatever calls it
+void uiprivParallelFor(size_t n, uiprivParallelFunc f, void *data)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		(*f)(data, i);
+}
+
+// nothing here draws; these only exist so uiDrawPathAddPolyline() links
+void uiDrawPathNewFigure(uiDrawPath *p, double x, double y)
+{
+}
+
+void uiDrawPathLineTo(uiDrawPath *p, double x, double y)
+{
+}
@@ -0,0 +1,80 @@
+// 19 october 2026
+#include "bench.h"
+
+// a mix of one-, two-, three-, and four-byte sequences, weighted toward ASCII like most real text
+static const char *const samples[] = {
+	"a", "b", "c", " ", "d", "e", "\xC3\xA9", "f", "\xE2\x82\xAC", "g", "h", "\xF0\x9F\x98\x80",
+};
+#define nSamples (sizeof (samples) / sizeof (samples[0]))
+
+static char *mkText(size_t size)
+{
+	char *buf;
+	size_t n, i, len;
+
+	buf = (char *) malloc(size + 1);
+	n = 0;
+	for (i = 0; ; i++) {
+		len = strlen(samples[i % nSamples]);
+		if (n + len > size)
+			break;
+		memcpy(buf + n, samples[i % nSamples], len);
+		n += len;
+	}
+	// pad out with ASCII so the size is exact
+	memset(buf + n, 'z', size - n);
+	buf[size] = '\0';
+	return buf;
+}
+
+static void benchDecodeRune(testingB *b, size_t size, void *data)
+{
+	char *text;
+	const char *p, *end;
+	uint32_t rune, sum;
+	int i;
+
+	testingBStopTimer(b);
+	text = mkText(size);
+	end = text + size;
+	testingBStartTimer(b);
+	sum = 0;
+	for (i = 0; i < testingBN(b); i++)
+		for (p = text; p < end; ) {
+			p = uiprivUTF8DecodeRune(p, end - p, &rune);
+			sum += rune;
+		}
+	testingBStopTimer(b);
+	// keep the loop from being optimized away
+	if (sum == 0xFFFFFFFF)
+		printf("%lu\n", (unsigned long) sum);
+	free(text);
+}
+
+testingBenchmark(UTF8DecodeRune)
+{
+	testingBRunSizes(b, 1000, 10000000, benchDecodeRune, NULL);
+}
+
+static void benchUTF16Count(testingB *b, size_t size, void *data)
+{
+	char *text;
+	size_t n;
+	int i;
+
+	testingBStopTimer(b);
+	text = mkText(size);
+	testingBStartTimer(b);
+	n = 0;
+	for (i = 0; i < testingBN(b); i++)
+		n += uiprivUTF8UTF16Count(text, size);
+	testingBStopTimer(b);
+	if (n == 0)
+		printf("%lu\n", (unsigned long) n);
+	free(text);
+}
+
+testingBenchmark(UTF8UTF16Count)
+{
+	testingBRunSizes(b, 1000, 10000000, benchUTF16Count, NULL);
+}
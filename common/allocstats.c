@@ -0,0 +1,224 @@
+// 19 october 2026
+#include <stdio.h>
+#include <stdlib.h>
+#include "../ui.h"
+#include "uipriv.h"
+
+// This keeps the per-type counters behind uiGetMemoryStats(). The OS-specific allocators call in here on every allocation, so the fast path is a single probe into a hash table keyed by the type string's address.
+// The same type name can have more than one address (one per file that uses it), so the first time we see an address we fall back to comparing the names and point the new address at the existing counters.
+// This can't use uiprivAlloc() itself, for obvious reasons.
+
+struct typeStats {
+	const char *type;
+	size_t liveBytes;
+	size_t liveCount;
+	size_t peakBytes;
+	uint64_t totalAllocs;
+};
+
+struct slot {
+	const char *type;		// NULL if empty
+	size_t index;		// into types
+};
+
+static struct typeStats *types = NULL;
+static size_t nTypes = 0;
+static size_t capTypes = 0;
+
+static struct slot *slots = NULL;
+static size_t nSlots = 0;		// always a power of 2
+static size_t nUsed = 0;
+
+static struct typeStats total;
+
+static void *mustRealloc(void *p, size_t n)
+{
+	p = realloc(p, n);
+	if (p == NULL) {
+		fprintf(stderr, "memory exhausted in uiprivAllocStats\n");
+		abort();
+	}
+	return p;
+}
+
+static size_t hashPointer(const char *p)
+{
+	uintptr_t x = (uintptr_t) p;
+
+	// string literals are at least byte-aligned and usually clustered, so mix the bits a bit
+	x ^= x >> 17;
+	x *= (uintptr_t) 0x9E3779B97F4A7C15ULL;
+	x ^= x >> 29;
+	return (size_t) x;
+}
+
+static struct slot *findSlot(struct slot *s, size_t n, const char *type)
+{
+	size_t i;
+
+	i = hashPointer(type) & (n - 1);
+	while (s[i].type != NULL && s[i].type != type)
+		i = (i + 1) & (n - 1);
+	return s + i;
+}
+
+static void grow(void)
+{
+	struct slot *old;
+	size_t oldn;
+	size_t i;
+
+	old = slots;
+	oldn = nSlots;
+	nSlots *= 2;
+	if (nSlots == 0)
+		nSlots = 64;
+	slots = (struct slot *) calloc(nSlots, sizeof (struct slot));
+	if (slots == NULL) {
+		fprintf(stderr, "memory exhausted in uiprivAllocStats\n");
+		abort();
+	}
+	for (i = 0; i < oldn; i++)
+		if (old[i].type != NULL)
+			*findSlot(slots, nSlots, old[i].type) = old[i];
+	free(old);
+}
+
+static struct typeStats *statsFor(const char *type)
+{
+	struct slot *s;
+	size_t i;
+
+	if (nSlots != 0) {
+		s = findSlot(slots, nSlots, type);
+		if (s->type != NULL)
+			return types + s->index;
+	}
+
+	// new address; see if it's a name we already know
+	for (i = 0; i < nTypes; i++)
+		if (strcmp(types[i].type, type) == 0)
+			break;
+	if (i == nTypes) {
+		if (nTypes == capTypes) {
+			capTypes = capTypes * 2 + 32;
+			types = (struct typeStats *) mustRealloc(types, capTypes * sizeof (struct typeStats));
+		}
+		memset(types + nTypes, 0, sizeof (struct typeStats));
+		types[nTypes].type = type;
+		nTypes++;
+	}
+
+	// keep the load factor under 1/2
+	if ((nUsed + 1) * 2 > nSlots)
+		grow();
+	s = findSlot(slots, nSlots, type);
+	s->type = type;
+	s->index = i;
+	nUsed++;
+	return types + i;
+}
+
+static void add(struct typeStats *t, size_t size)
+{
+	t->liveBytes += size;
+	if (t->peakBytes < t->liveBytes)
+		t->peakBytes = t->liveBytes;
+}
+
+void uiprivAllocStatsAlloc(const char *type, size_t size)
+{
+	struct typeStats *t;
+
+	t = statsFor(type);
+	add(t, size);
+	t->liveCount++;
+	t->totalAllocs++;
+	add(&total, size);
+	total.liveCount++;
+	total.totalAllocs++;
+}
+
+void uiprivAllocStatsRealloc(const char *type, size_t oldSize, size_t newSize)
+{
+	struct typeStats *t;
+
+	t = statsFor(type);
+	t->liveBytes -= oldSize;
+	add(t, newSize);
+	total.liveBytes -= oldSize;
+	add(&total, newSize);
+}
+
+void uiprivAllocStatsFree(const char *type, size_t size)
+{
+	struct typeStats *t;
+
+	t = statsFor(type);
+	t->liveBytes -= size;
+	t->liveCount--;
+	total.liveBytes -= size;
+	total.liveCount--;
+}
+
+void uiprivUninitAllocStats(void)
+{
+	free(slots);
+	slots = NULL;
+	nSlots = 0;
+	nUsed = 0;
+	free(types);
+	types = NULL;
+	nTypes = 0;
+	capTypes = 0;
+	memset(&total, 0, sizeof (struct typeStats));
+}
+
+static void copyStats(uiMemoryTypeStats *out, const struct typeStats *in)
+{
+	out->Type = in->type;
+	out->LiveBytes = in->liveBytes;
+	out->LiveCount = in->liveCount;
+	out->PeakBytes = in->peakBytes;
+	out->TotalAllocs = in->totalAllocs;
+}
+
+static int liveBytesCmp(const void *a, const void *b)
+{
+	const uiMemoryTypeStats *x = (const uiMemoryTypeStats *) a;
+	const uiMemoryTypeStats *y = (const uiMemoryTypeStats *) b;
+
+	if (x->LiveBytes > y->LiveBytes)
+		return -1;
+	if (x->LiveBytes < y->LiveBytes)
+		return 1;
+	return strcmp(x->Type, y->Type);
+}
+
+// the snapshot is allocated with malloc() so that taking one doesn't change the numbers in it, and so that a snapshot still held at uiUninit() time isn't reported as a leak
+uiMemoryStats *uiGetMemoryStats(void)
+{
+	uiMemoryStats *s;
+	size_t i;
+
+	s = (uiMemoryStats *) mustRealloc(NULL, sizeof (uiMemoryStats));
+	s->LiveBytes = total.liveBytes;
+	s->LiveCount = total.liveCount;
+	s->PeakBytes = total.peakBytes;
+	s->TotalAllocs = total.totalAllocs;
+	s->NumTypes = nTypes;
+	s->Types = NULL;
+	if (nTypes != 0) {
+		s->Types = (uiMemoryTypeStats *) mustRealloc(NULL, nTypes * sizeof (uiMemoryTypeStats));
+		for (i = 0; i < nTypes; i++)
+			copyStats(s->Types + i, types + i);
+		qsort(s->Types, nTypes, sizeof (uiMemoryTypeStats), liveBytesCmp);
+	}
+	return s;
+}
+
+void uiFreeMemoryStats(uiMemoryStats *s)
+{
+	free(s->Types);
+	free(s);
+}
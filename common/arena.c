@@ -0,0 +1,121 @@
+// 19 october 2026
+#include "../ui.h"
+#include "uipriv.h"
+
+// A uiprivArena hands out memory by bumping a pointer through large blocks, and takes it all back at once with uiprivArenaReset().
+// After a reset, if the last round needed more than one block, they are replaced by a single block big enough for all of them, so a steady workload settles into one block and no allocations at all.
+// Like everything else from uiprivAlloc(), arena memory is zero-filled.
+
+#define firstBlockSize 8192
+
+// keep everything aligned for doubles and pointers alike
+#define align 16
+#define roundUp(n) (((n) + (align - 1)) & ~((size_t) (align - 1)))
+
+struct block {
+	struct block *next;		// the previous (smaller) block
+	size_t size;
+	size_t used;
+	// data follows, starting at headerSize
+};
+
+#define headerSize roundUp(sizeof (struct block))
+#define blockData(b) (((uint8_t *) (b)) + headerSize)
+
+struct uiprivArena {
+	struct block *cur;
+	void *last;		// most recent allocation in cur, for growing in place
+	size_t total;		// of all block sizes
+};
+
+static struct block *newBlock(size_t size, struct block *next)
+{
+	struct block *b;
+
+	b = (struct block *) uiprivAlloc(headerSize + size, "uint8_t[] (uiprivArena)");
+	b->next = next;
+	b->size = size;
+	b->used = 0;
+	return b;
+}
+
+uiprivArena *uiprivNewArena(void)
+{
+	uiprivArena *a;
+
+	a = uiprivNew(uiprivArena);
+	a->cur = newBlock(firstBlockSize, NULL);
+	a->total = firstBlockSize;
+	return a;
+}
+
+static void freeBlocks(struct block *b)
+{
+	struct block *next;
+
+	for (; b != NULL; b = next) {
+		next = b->next;
+		uiprivFree(b);
+	}
+}
+
+void uiprivFreeArena(uiprivArena *a)
+{
+	freeBlocks(a->cur);
+	uiprivFree(a);
+}
+
+void *uiprivArenaAlloc(uiprivArena *a, size_t size)
+{
+	size_t n;
+	void *out;
+
+	size = roundUp(size);
+	if (a->cur->size - a->cur->used < size) {
+		n = a->cur->size * 2;
+		if (n < size)
+			n = size;
+		a->cur = newBlock(n, a->cur);
+		a->total += n;
+	}
+	out = blockData(a->cur) + a->cur->used;
+	a->cur->used += size;
+	// new blocks are already zeroed, but reused ones aren't
+	memset(out, 0, size);
+	a->last = out;
+	return out;
+}
+
+void *uiprivArenaRealloc(uiprivArena *a, void *p, size_t oldSize, size_t newSize)
+{
+	uint8_t *end;
+	void *out;
+
+	if (p == NULL)
+		return uiprivArenaAlloc(a, newSize);
+	if (newSize <= oldSize)
+		return p;
+	// if p is the last thing we handed out, we can just move the end of it
+	if (p == a->last) {
+		end = blockData(a->cur) + a->cur->used;
+		if (((uint8_t *) p) + roundUp(newSize) <= blockData(a->cur) + a->cur->size) {
+			a->cur->used = (((uint8_t *) p) + roundUp(newSize)) - blockData(a->cur);
+			memset(end, 0, (blockData(a->cur) + a->cur->used) - end);
+			return p;
+		}
+	}
+	out = uiprivArenaAlloc(a, newSize);
+	memcpy(out, p, oldSize);
+	return out;
+}
+
+void uiprivArenaReset(uiprivArena *a)
+{
+	if (a->cur->next != NULL) {
+		// coalesce
+		freeBlocks(a->cur);
+		a->cur = newBlock(a->total, NULL);
+	}
+	a->cur->used = 0;
+	a->last = NULL;
+}
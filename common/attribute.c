@@ -24,6 +24,9 @@ struct uiAttribute {
 		uiUnderline underline;
 		uiOpenTypeFeatures *features;
 	} u;
+	// the OS-specific code can cache its own conversion of the attribute here; see uiprivAttributeSetOSData()
+	void *osData;
+	void (*freeOSData)(void *osData);
 };
 
 static uiAttribute *newAttribute(uiAttributeType type)
@@ -48,6 +51,8 @@ uiAttribute *uiprivAttributeRetain(uiAttribute *a)
 
 static void destroy(uiAttribute *a)
 {
+	if (a->freeOSData != NULL)
+		(*(a->freeOSData))(a->osData);
 	switch (a->type) {
 	case uiAttributeTypeFamily:
 		uiprivFree(a->u.family);
@@ -235,7 +240,7 @@ int uiprivAttributeEqual(const uiAttribute *a, const uiAttribute *b)
 		return 0;
 	switch (a->type) {
 	case uiAttributeTypeFamily:
-		return uiprivStricmp(a->u.family, b->u.family);
+		return uiprivStricmp(a->u.family, b->u.family) == 0;
 	case uiAttributeTypeSize:
 		// TODO is the use of == correct?
 		return a->u.size == b->u.size;
@@ -264,3 +269,91 @@ int uiprivAttributeEqual(const uiAttribute *a, const uiAttribute *b)
 	// TODO should not be reached
 	return 0;
 }
+
+// FNV-1a; this only needs to be consistent with uiprivAttributeEqual(), not good
+#define hashInit ((size_t) 2166136261u)
+
+static size_t hashBytes(size_t h, const void *p, size_t n)
+{
+	const uint8_t *b = (const uint8_t *) p;
+
+	for (; n != 0; n--) {
+		h ^= *b++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+static size_t hashDouble(size_t h, double d)
+{
+	// 0.0 == -0.0, so they must hash the same
+	if (d == 0)
+		d = 0;
+	return hashBytes(h, &d, sizeof (double));
+}
+
+size_t uiprivAttributeHash(const uiAttribute *a)
+{
+	size_t h;
+	const char *c;
+	uint8_t lower;
+
+	h = hashBytes(hashInit, &(a->type), sizeof (uiAttributeType));
+	switch (a->type) {
+	case uiAttributeTypeFamily:
+		// family names compare case-insensitively
+		for (c = a->u.family; *c != '\0'; c++) {
+			lower = (uint8_t) (*c);
+			if (lower >= 'A' && lower <= 'Z')
+				lower += 'a' - 'A';
+			h = hashBytes(h, &lower, 1);
+		}
+		break;
+	case uiAttributeTypeSize:
+		h = hashDouble(h, a->u.size);
+		break;
+	case uiAttributeTypeWeight:
+		h = hashBytes(h, &(a->u.weight), sizeof (uiTextWeight));
+		break;
+	case uiAttributeTypeItalic:
+		h = hashBytes(h, &(a->u.italic), sizeof (uiTextItalic));
+		break;
+	case uiAttributeTypeStretch:
+		h = hashBytes(h, &(a->u.stretch), sizeof (uiTextStretch));
+		break;
+	case uiAttributeTypeUnderline:
+		h = hashBytes(h, &(a->u.underline), sizeof (uiUnderline));
+		break;
+	case uiAttributeTypeUnderlineColor:
+		h = hashBytes(h, &(a->u.color.underlineColor), sizeof (uiUnderlineColor));
+		// fall through
+	case uiAttributeTypeColor:
+	case uiAttributeTypeBackground:
+		h = hashDouble(h, a->u.color.r);
+		h = hashDouble(h, a->u.color.g);
+		h = hashDouble(h, a->u.color.b);
+		h = hashDouble(h, a->u.color.a);
+		break;
+	case uiAttributeTypeFeatures:
+		h ^= uiprivOpenTypeFeaturesHash(a->u.features);
+		break;
+	}
+	return h;
+}
+
+void *uiprivAttributeOSData(const uiAttribute *a)
+{
+	return a->osData;
+}
+
+// the cached data is freed with f when a is destroyed
+// this is allowed on const attributes since it doesn't change the value of the attribute
+void uiprivAttributeSetOSData(const uiAttribute *a, void *data, void (*f)(void *data))
+{
+	uiAttribute *m = (uiAttribute *) a;
+
+	if (m->freeOSData != NULL)
+		(*(m->freeOSData))(m->osData);
+	m->osData = data;
+	m->freeOSData = f;
+}
@@ -1,4 +1,5 @@
 // 16 december 2016
+#include <stdlib.h>
 #include "../ui.h"
 #include "uipriv.h"
 #include "attrstr.h"
@@ -8,9 +9,9 @@ An attribute list is a doubly linked list of attributes.
 Attribute start positions are inclusive and attribute end positions are exclusive (or in other words, [start, end)).
 The list is kept sorted in increasing order by start position. Whether or not the sort is stable is undefined, so no temporal information should be expected to stay.
 Overlapping attributes are not allowed; if an attribute is added that conflicts with an existing one, the existing one is removed.
-In addition, the linked list tries to reduce fragmentation: if an attribute is added that just expands another, then there will only be one entry in alist, not two. (TODO does it really?)
+In addition, the linked list tries to reduce fragmentation: if an attribute is added that just expands another, then there will only be one entry in alist, not two.
 The linked list is not a ring; alist->fist->prev == NULL and alist->last->next == NULL.
-TODO verify that this disallows attributes of length zero
+For lookups by position, there's also an index: an array of all the attributes grouped by type, each group in list order. Since attributes of the same type never overlap, both the starts and the ends in each group are sorted, so a binary search finds the first one that reaches a given position. The index is built on first use and thrown away on any change to the list.
 */
 
 struct attr {
@@ -21,11 +22,24 @@ struct attr {
 	struct attr *next;
 };
 
+#define nAttrTypes (uiAttributeTypeFeatures + 1)
+
 struct uiprivAttrList {
 	struct attr *first;
 	struct attr *last;
+
+	struct attr **index;
+	size_t indexCap;
+	// the attributes of type t are index[typeStart[t]] through index[typeStart[t + 1] - 1]
+	size_t typeStart[nAttrTypes + 1];
+	int indexValid;
 };
 
+static void invalidateIndex(uiprivAttrList *alist)
+{
+	alist->indexValid = 0;
+}
+
 // if before is NULL, add to the end of the list
 static void attrInsertBefore(uiprivAttrList *alist, struct attr *a, struct attr *before)
 {
@@ -189,27 +203,6 @@ static struct attr *attrDropRange(uiprivAttrList *alist, struct attr *a, size_t
 	return a->next;
 }
 
-static void attrGrow(uiprivAttrList *alist, struct attr *a, size_t start, size_t end)
-{
-	struct attr *before;
-
-	// adjusting the end is simple: if it ends before our new end, just set the new end
-	if (a->end < end)
-		a->end = end;
-
-	// adjusting the start is harder
-	// if the start is before our new start, we are done
-	// otherwise, we have to move the start back AND reposition the attribute to keep the sorted order
-	if (a->start <= start)
-		return;
-	a->start = start;
-	attrUnlink(alist, a);
-	for (before = alist->first; before != NULL; before = before->next)
-		if (before->start > a->start)
-			break;
-	attrInsertBefore(alist, a, before);
-}
-
 // returns the right side of the split, which is unlinked, or NULL if no split was done
 static struct attr *attrSplitAt(uiprivAttrList *alist, struct attr *a, size_t at)
 {
@@ -303,70 +296,93 @@ void uiprivFreeAttrList(uiprivAttrList *alist)
 		uiprivFree(a);
 		a = next;
 	}
+	if (alist->index != NULL)
+		uiprivFree(alist->index);
 	uiprivFree(alist);
 }
 
 void uiprivAttrListInsertAttribute(uiprivAttrList *alist, uiAttribute *val, size_t start, size_t end)
 {
-	struct attr *a;
-	struct attr *before;
+	struct attr *a, *cur, *next;
+	struct attr *before = NULL;
 	struct attr *tail = NULL;
-	int split = 0;
+	struct attr *left = NULL, *right = NULL;
 	uiAttributeType valtype;
-
-	// first, figure out where in the list this should go
-	// in addition, if this attribute overrides one that already exists, split that one apart so this one can take over
-	before = alist->first;
+	size_t lstart, lend;
+	int keepsLeft;
+
+	invalidateIndex(alist);
+	// hold a reference for the duration, so if val isn't used it gets destroyed at the end instead of leaking
+	uiprivAttributeRetain(val);
+	if (start == end)
+		goto out;
 	valtype = uiAttributeGetType(val);
-	while (before != NULL) {
-		size_t lstart, lend;
-
-		// once we get to the first point after start, we know where to insert
-		if (before->start > start)
-			break;
 
-		// if we have already split a prior instance of this attribute, don't bother doing it again
-		if (split)
-			goto next;
-
-		// should we split this attribute?
-		if (uiAttributeGetType(before->val) != valtype)
-			goto next;
+	// first, clear out everything of this type in the range and figure out where in the list this should go
+	// this has to look at every attribute that starts before end, not just the ones that start before start
+	// in addition, look for equal attributes right next to the range, so we can grow one of those instead of fragmenting
+	a = alist->first;
+	while (a != NULL) {
 		lstart = start;
 		lend = end;
-		if (!attrRangeIntersect(before, &lstart, &lend))
-			goto next;
-
-		// okay so this might conflict; if the val is the same as the one we want, we need to expand the existing attribute, not fragment anything
-		// TODO will this reduce fragmentation if we first add from 0 to 2 and then from 2 to 4? or do we have to do that separately?
-		if (uiprivAttributeEqual(before->val, val)) {
-			attrGrow(alist, before, start, end);
-			return;
+		if (uiAttributeGetType(a->val) == valtype && a->start < end && attrRangeIntersect(a, &lstart, &lend)) {
+			// since attributes of the same type don't overlap, only one of these can stick out past end, so there's only ever one tail
+			cur = a;
+			keepsLeft = a->start < start;
+			a = attrDropRange(alist, a, start, end, &tail);
+			if (keepsLeft && uiprivAttributeEqual(cur->val, val))
+				left = cur;
+			continue;
 		}
-		// okay the values are different; we need to split apart
-		before = attrDropRange(alist, before, start, end, &tail);
-		split = 1;
-		continue;
-
-	next:
-		before = before->next;
+		if (before == NULL && a->start > start)
+			before = a;
+		if (a->start > end)
+			break;
+		if ((a->end == start || a->start == end) && uiAttributeGetType(a->val) == valtype && uiprivAttributeEqual(a->val, val)) {
+			if (a->end == start)
+				left = a;
+			if (a->start == end)
+				right = a;
+		}
+		a = a->next;
 	}
+	// a is now the first attribute that starts after end, which is where tail goes back in
+	if (tail != NULL && uiprivAttributeEqual(tail->val, val))
+		right = tail;
+
+	if (left != NULL && right != NULL) {
+		left->end = right->end;
+		if (right == tail) {
+			uiprivAttributeRelease(tail->val);
+			uiprivFree(tail);
+			tail = NULL;
+		} else
+			attrDelete(alist, right);
+	} else if (left != NULL)
+		left->end = end;
+	else if (right != NULL) {
+		// this moves right's start back, so it needs to move in the list too
+		if (right == tail)
+			tail = NULL;
+		else {
+			next = attrUnlink(alist, right);
+			if (before == right)
+				before = next;
+		}
+		right->start = start;
+		attrInsertBefore(alist, right, before);
+	} else {
+		cur = uiprivNew(struct attr);
+		cur->val = uiprivAttributeRetain(val);
+		cur->start = start;
+		cur->end = end;
+		attrInsertBefore(alist, cur, before);
+	}
+	if (tail != NULL)
+		attrInsertBefore(alist, tail, a);
 
-	// if we got here, we know we have to add the attribute before before
-	a = uiprivNew(struct attr);
-	a->val = uiprivAttributeRetain(val);
-	a->start = start;
-	a->end = end;
-	attrInsertBefore(alist, a, before);
-
-	// and finally, if we split, insert the remainder
-	if (tail == NULL)
-		return;
-	// note we start at before; it won't be inserted before that by the sheer nature of how the code above works
-	for (; before != NULL; before = before->next)
-		if (before->start > tail->start)
-			break;
-	attrInsertBefore(alist, tail, before);
+out:
+	uiprivAttributeRelease(val);
 }
 
 void uiprivAttrListInsertCharactersUnattributed(uiprivAttrList *alist, size_t start, size_t count)
@@ -374,6 +390,8 @@ void uiprivAttrListInsertCharactersUnattributed(uiprivAttrList *alist, size_t st
 	struct attr *a;
 	struct attr *tails = NULL;
 
+	invalidateIndex(alist);
+
 	// every attribute before the insertion point can either cross into the insertion point or not
 	// if it does, we need to split that attribute apart at the insertion point, keeping only the old attribute in place, adjusting the new tail, and preparing it for being re-added later
 	for (a = alist->first; a != NULL; a = a->next) {
@@ -486,6 +504,7 @@ void uiprivAttrListInsertCharactersExtendingAttributes(uiprivAttrList *alist, si
 {
 	struct attr *a;
 
+	invalidateIndex(alist);
 	for (a = alist->first; a != NULL; a = a->next) {
 		if (a->start < start)
 			a->start += count;
@@ -504,6 +523,7 @@ void uiprivAttrListRemoveAttribute(uiprivAttrList *alist, uiAttributeType type,
 	struct attr *tails = NULL;		// see uiprivAttrListInsertCharactersUnattributed() above
 	struct attr *tailsAt = NULL;
 
+	invalidateIndex(alist);
 	a = alist->first;
 	while (a != NULL) {
 		size_t lstart, lend;
@@ -551,6 +571,7 @@ void uiprivAttrListRemoveAttributes(uiprivAttrList *alist, size_t start, size_t
 	struct attr *tails = NULL;		// see uiprivAttrListInsertCharactersUnattributed() above
 	struct attr *tailsAt = NULL;
 
+	invalidateIndex(alist);
 	a = alist->first;
 	while (a != NULL) {
 		size_t lstart, lend;
@@ -593,6 +614,7 @@ void uiprivAttrListRemoveCharacters(uiprivAttrList *alist, size_t start, size_t
 {
 	struct attr *a;
 
+	invalidateIndex(alist);
 	a = alist->first;
 	while (a != NULL)
 		a = attrDeleteRange(alist, a, start, end);
@@ -610,3 +632,402 @@ void uiprivAttrListForEach(const uiprivAttrList *alist, const uiAttributedString
 			break;
 	}
 }
+
+static int attrStartCmp(const void *a, const void *b)
+{
+	const struct attr *x = *((const struct attr **) a);
+	const struct attr *y = *((const struct attr **) b);
+
+	if (x->start < y->start)
+		return -1;
+	if (x->start > y->start)
+		return 1;
+	return 0;
+}
+
+static void buildIndex(uiprivAttrList *alist)
+{
+	struct attr *a;
+	size_t next[nAttrTypes];
+	size_t n;
+	int t;
+
+	memset(alist->typeStart, 0, sizeof (alist->typeStart));
+	n = 0;
+	for (a = alist->first; a != NULL; a = a->next) {
+		alist->typeStart[uiAttributeGetType(a->val) + 1]++;
+		n++;
+	}
+	for (t = 0; t < nAttrTypes; t++)
+		alist->typeStart[t + 1] += alist->typeStart[t];
+	if (n > alist->indexCap) {
+		alist->indexCap = n;
+		alist->index = (struct attr **) uiprivRealloc(alist->index, alist->indexCap * sizeof (struct attr *), "struct attr *[] (uiprivAttrList)");
+	}
+	memcpy(next, alist->typeStart, sizeof (next));
+	for (a = alist->first; a != NULL; a = a->next)
+		alist->index[next[uiAttributeGetType(a->val)]++] = a;
+	// the list should already be sorted, but uiprivAttrListInsertCharactersExtendingAttributes() doesn't promise it
+	for (t = 0; t < nAttrTypes; t++)
+		for (n = alist->typeStart[t] + 1; n < alist->typeStart[t + 1]; n++)
+			if (alist->index[n]->start < alist->index[n - 1]->start) {
+				qsort(alist->index + alist->typeStart[t],
+					alist->typeStart[t + 1] - alist->typeStart[t],
+					sizeof (struct attr *), attrStartCmp);
+				break;
+			}
+	alist->indexValid = 1;
+}
+
+// returns the position in v of the first attribute that ends after pos
+static size_t firstEndingAfter(struct attr **v, size_t n, size_t pos)
+{
+	size_t lo, hi, mid;
+
+	lo = 0;
+	hi = n;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (v[mid]->end > pos)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo;
+}
+
+// visits every attribute that overlaps [start, end), in order of start position
+// this is a merge of the per-type groups of the index, so it costs O(log n) per type to get going and O(number of types) per attribute visited
+void uiprivAttrListForEachInRange(const uiprivAttrList *alist, const uiAttributedString *s, size_t start, size_t end, uiAttributedStringForEachAttributeFunc f, void *data)
+{
+	// the index is only a cache, so building it doesn't really change alist
+	uiprivAttrList *ml = (uiprivAttrList *) alist;
+	size_t cur[nAttrTypes];
+	struct attr *a;
+	uiForEach ret;
+	int t, which;
+
+	if (!ml->indexValid)
+		buildIndex(ml);
+	for (t = 0; t < nAttrTypes; t++)
+		cur[t] = ml->typeStart[t] + firstEndingAfter(ml->index + ml->typeStart[t],
+			ml->typeStart[t + 1] - ml->typeStart[t], start);
+	for (;;) {
+		a = NULL;
+		which = 0;
+		for (t = 0; t < nAttrTypes; t++) {
+			if (cur[t] == ml->typeStart[t + 1])
+				continue;
+			if (ml->index[cur[t]]->start >= end)
+				continue;
+			if (a == NULL || ml->index[cur[t]]->start < a->start) {
+				a = ml->index[cur[t]];
+				which = t;
+			}
+		}
+		if (a == NULL)
+			break;
+		cur[which]++;
+		ret = (*f)(s, a->val, a->start, a->end, data);
+		if (ret == uiForEachStop)
+			break;
+	}
+}
+
+struct copyRangeData {
+	uiprivAttrList *dst;
+	size_t start;
+	size_t end;
+};
+
+static uiForEach copyRangeFunc(const uiAttributedString *s, const uiAttribute *val, size_t start, size_t end, void *data)
+{
+	struct copyRangeData *d = (struct copyRangeData *) data;
+	struct attr *b;
+
+	if (start < d->start)
+		start = d->start;
+	if (end > d->end)
+		end = d->end;
+	// an empty range still visits the attributes around it
+	if (start >= end)
+		return uiForEachContinue;
+	b = uiprivNew(struct attr);
+	b->val = uiprivAttributeRetain((uiAttribute *) val);
+	b->start = start - d->start;
+	b->end = end - d->start;
+	attrInsertBefore(d->dst, b, NULL);
+	return uiForEachContinue;
+}
+
+// appends the parts of the attributes in src that fall in [start, end) to dst, shifted so that start becomes 0
+// dst must not have any attributes in or after that range already
+// this goes through the index, so it only costs as much as what's in the range and not as much as everything in src before it; since that visits attributes in order of start and clipping to the range keeps that order, this can append directly instead of going through uiprivAttrListInsertAttribute()
+void uiprivAttrListCopyRange(uiprivAttrList *dst, const uiprivAttrList *src, size_t start, size_t end)
+{
+	struct copyRangeData d;
+
+	invalidateIndex(dst);
+	d.dst = dst;
+	d.start = start;
+	d.end = end;
+	uiprivAttrListForEachInRange(src, NULL, start, end, copyRangeFunc, &d);
+}
+
+// uiprivAttrListInsertRuns() merges equal attributes through this hash table
+// every attribute in it holds an extra reference until the insert is done, so nothing it hands out can be destroyed partway through, and anything nobody ends up using is destroyed at the end
+struct internTable {
+	uiAttribute **slots;
+	size_t nSlots;		// always a power of 2
+	size_t n;
+};
+
+static void internInit(struct internTable *t)
+{
+	t->nSlots = 64;
+	t->slots = (uiAttribute **) uiprivAlloc(t->nSlots * sizeof (uiAttribute *), "uiAttribute *[] (uiprivAttrList)");
+	t->n = 0;
+}
+
+static uiAttribute **internFind(uiAttribute **slots, size_t nSlots, const uiAttribute *a)
+{
+	size_t i;
+
+	i = uiprivAttributeHash(a) & (nSlots - 1);
+	while (slots[i] != NULL && slots[i] != a && !uiprivAttributeEqual(slots[i], a))
+		i = (i + 1) & (nSlots - 1);
+	return slots + i;
+}
+
+// returns the attribute to use in place of a
+static uiAttribute *intern(struct internTable *t, uiAttribute *a)
+{
+	uiAttribute **slot;
+	uiAttribute **old;
+	size_t i, oldn;
+
+	slot = internFind(t->slots, t->nSlots, a);
+	if (*slot != NULL)
+		return *slot;
+	*slot = uiprivAttributeRetain(a);
+	t->n++;
+	// keep the load factor under 1/2
+	if (t->n * 2 > t->nSlots) {
+		old = t->slots;
+		oldn = t->nSlots;
+		t->nSlots *= 2;
+		t->slots = (uiAttribute **) uiprivAlloc(t->nSlots * sizeof (uiAttribute *), "uiAttribute *[] (uiprivAttrList)");
+		for (i = 0; i < oldn; i++)
+			if (old[i] != NULL)
+				*internFind(t->slots, t->nSlots, old[i]) = old[i];
+		uiprivFree(old);
+	}
+	return a;
+}
+
+static void internUninit(struct internTable *t)
+{
+	size_t i;
+
+	for (i = 0; i < t->nSlots; i++)
+		if (t->slots[i] != NULL)
+			uiprivAttributeRelease(t->slots[i]);
+	uiprivFree(t->slots);
+}
+
+static int ptrCmp(const void *a, const void *b)
+{
+	uintptr_t x = (uintptr_t) (*((void *const *) a));
+	uintptr_t y = (uintptr_t) (*((void *const *) b));
+
+	if (x < y)
+		return -1;
+	if (x > y)
+		return 1;
+	return 0;
+}
+
+static void freeNode(struct attr *a)
+{
+	uiprivAttributeRelease(a->val);
+	uiprivFree(a);
+}
+
+// appends [start, end) with val to out, extending the last entry instead if it's adjacent and equal
+// if *spare is not NULL, it is an old node that already holds a reference to val; the first new entry takes it over
+static void emit(struct attr **out, size_t *n, uiAttribute *val, size_t start, size_t end, struct attr **spare)
+{
+	struct attr *a;
+
+	if (start == end)
+		return;
+	if (*n != 0) {
+		a = out[*n - 1];
+		if (a->end == start && (a->val == val || uiprivAttributeEqual(a->val, val))) {
+			a->end = end;
+			return;
+		}
+	}
+	if (spare != NULL && *spare != NULL) {
+		a = *spare;
+		*spare = NULL;
+	} else {
+		a = uiprivNew(struct attr);
+		a->val = uiprivAttributeRetain(val);
+	}
+	a->start = start;
+	a->end = end;
+	out[*n] = a;
+	(*n)++;
+}
+
+// merges the runs of one type into the old attributes of that type; the runs win wherever they overlap
+// both old and the runs are sorted and free of overlaps, so this is a single pass over each
+static size_t mergeType(struct attr **old, size_t nOld, const uiAttributeRun *runs, const size_t *which, uiAttribute *const *vals, size_t nRuns, struct attr **out)
+{
+	const uiAttributeRun *r;
+	struct attr *spare;
+	size_t i, j, n;
+	// what's left of old[i]; this is kept separately because emit() can reuse old[i] itself for an earlier piece
+	uiAttribute *ov;
+	size_t os, oe;
+
+	n = 0;
+	i = 0;
+	spare = NULL;
+	ov = NULL;
+	os = 0;
+	oe = 0;
+#define advance() \
+	if (spare != NULL) \
+		freeNode(spare); \
+	spare = NULL; \
+	if (i < nOld) { \
+		spare = old[i]; \
+		ov = old[i]->val; \
+		os = old[i]->start; \
+		oe = old[i]->end; \
+	}
+	advance();
+	for (j = 0; j < nRuns; j++) {
+		r = runs + which[j];
+		while (i < nOld && oe <= r->Start) {
+			emit(out, &n, ov, os, oe, &spare);
+			i++;
+			advance();
+		}
+		if (i < nOld && os < r->Start)
+			emit(out, &n, ov, os, r->Start, &spare);
+		emit(out, &n, vals[which[j]], r->Start, r->End, NULL);
+		while (i < nOld && oe <= r->End) {
+			i++;
+			advance();
+		}
+		if (i < nOld && os < r->End)
+			os = r->End;
+	}
+	while (i < nOld) {
+		emit(out, &n, ov, os, oe, &spare);
+		i++;
+		advance();
+	}
+#undef advance
+	return n;
+}
+
+// this does the same thing as calling uiprivAttrListInsertAttribute() on each run in order, in time linear in the size of alist and the number of runs
+// the runs must be sorted by start and runs of the same type must not overlap; the caller checks that
+void uiprivAttrListInsertRuns(uiprivAttrList *alist, const uiAttributeRun *runs, size_t n)
+{
+	struct internTable t;
+	uiAttribute **vals;
+	uiAttribute **discard;
+	size_t nDiscard;
+	size_t *which;
+	struct attr **out;
+	size_t runStart[nAttrTypes + 1];
+	size_t outStart[nAttrTypes];
+	size_t outN[nAttrTypes];
+	size_t next[nAttrTypes];
+	size_t i, nOld;
+	struct attr *a;
+	int ty, k;
+
+	if (!alist->indexValid)
+		buildIndex(alist);
+	nOld = alist->typeStart[nAttrTypes];
+
+	// intern everything, starting with what's already here so the runs can share those too
+	internInit(&t);
+	for (i = 0; i < nOld; i++)
+		intern(&t, alist->index[i]->val);
+	vals = (uiAttribute **) uiprivAlloc(n * sizeof (uiAttribute *), "uiAttribute *[] (uiprivAttrList)");
+	discard = (uiAttribute **) uiprivAlloc(n * sizeof (uiAttribute *), "uiAttribute *[] (uiprivAttrList)");
+	nDiscard = 0;
+	memset(runStart, 0, sizeof (runStart));
+	for (i = 0; i < n; i++) {
+		vals[i] = intern(&t, runs[i].Attribute);
+		if (vals[i] != runs[i].Attribute)
+			discard[nDiscard++] = runs[i].Attribute;
+		if (runs[i].Start != runs[i].End)
+			runStart[uiAttributeGetType(vals[i]) + 1]++;
+	}
+
+	// group the nonempty runs by type, keeping their order
+	for (ty = 0; ty < nAttrTypes; ty++)
+		runStart[ty + 1] += runStart[ty];
+	which = (size_t *) uiprivAlloc((runStart[nAttrTypes] + 1) * sizeof (size_t), "size_t[] (uiprivAttrList)");
+	memcpy(next, runStart, sizeof (next));
+	for (i = 0; i < n; i++)
+		if (runs[i].Start != runs[i].End)
+			which[next[uiAttributeGetType(vals[i])]++] = i;
+
+	// every run can add itself and split one old attribute in two
+	out = (struct attr **) uiprivAlloc((nOld + 2 * runStart[nAttrTypes] + 1) * sizeof (struct attr *), "struct attr *[] (uiprivAttrList)");
+	i = 0;
+	for (ty = 0; ty < nAttrTypes; ty++) {
+		outStart[ty] = i;
+		outN[ty] = mergeType(alist->index + alist->typeStart[ty],
+			alist->typeStart[ty + 1] - alist->typeStart[ty],
+			runs, which + runStart[ty], vals,
+			runStart[ty + 1] - runStart[ty],
+			out + i);
+		i += outN[ty];
+	}
+
+	// and stitch the types back together in order of start
+	alist->first = NULL;
+	alist->last = NULL;
+	memset(next, 0, sizeof (next));
+	for (;;) {
+		a = NULL;
+		k = 0;
+		for (ty = 0; ty < nAttrTypes; ty++) {
+			if (next[ty] == outN[ty])
+				continue;
+			if (a == NULL || out[outStart[ty] + next[ty]]->start < a->start) {
+				a = out[outStart[ty] + next[ty]];
+				k = ty;
+			}
+		}
+		if (a == NULL)
+			break;
+		next[k]++;
+		a->prev = NULL;
+		a->next = NULL;
+		attrInsertBefore(alist, a, NULL);
+	}
+	invalidateIndex(alist);
+
+	// the same duplicate can be in more than one run, so only free each once
+	qsort(discard, nDiscard, sizeof (uiAttribute *), ptrCmp);
+	for (i = 0; i < nDiscard; i++)
+		if (i == 0 || discard[i] != discard[i - 1])
+			uiFreeAttribute(discard[i]);
+	internUninit(&t);
+
+	uiprivFree(out);
+	uiprivFree(which);
+	uiprivFree(discard);
+	uiprivFree(vals);
+}
@@ -3,6 +3,15 @@
 #include "uipriv.h"
 #include "attrstr.h"
 
+// how many changes uiAttributedStringChangedSince() can see back through before it has to give up and say everything changed
+#define nChanges 32
+
+// a range of bytes that changed, kept in the string's current coordinates
+struct change {
+	size_t start;
+	size_t end;
+};
+
 struct uiAttributedString {
 	char *s;
 	size_t len;
@@ -19,6 +28,10 @@ struct uiAttributedString {
 
 	// this is lazily created to keep things from getting *too* slow
 	uiprivGraphemes *graphemes;
+
+	// every change bumps generation and goes in changes[generation % nChanges]
+	uint64_t generation;
+	struct change changes[nChanges];
 };
 
 static void resize(uiAttributedString *s, size_t u8, size_t u16)
@@ -63,6 +76,51 @@ static void invalidateGraphemes(uiAttributedString *s)
 	s->graphemes = NULL;
 }
 
+static void recordChange(uiAttributedString *s, size_t start, size_t end)
+{
+	s->generation++;
+	s->changes[s->generation % nChanges].start = start;
+	s->changes[s->generation % nChanges].end = end;
+}
+
+// the older entries in changes are moved along with the text, so they can all be merged as-is
+// entries that are too old to matter get moved too; that's harmless
+static void shiftChangesForInsert(uiAttributedString *s, size_t at, size_t count)
+{
+	struct change *c;
+	int i;
+
+	for (i = 0; i < nChanges; i++) {
+		c = s->changes + i;
+		// an empty range at at marks a deletion there; keep it attached to the text after it, like its start
+		if (c->end > at || (c->end == at && c->start == at))
+			c->end += count;
+		if (c->start >= at)
+			c->start += count;
+	}
+}
+
+static size_t posAfterDelete(size_t pos, size_t start, size_t end)
+{
+	if (pos <= start)
+		return pos;
+	if (pos >= end)
+		return pos - (end - start);
+	return start;
+}
+
+static void shiftChangesForDelete(uiAttributedString *s, size_t start, size_t end)
+{
+	struct change *c;
+	int i;
+
+	for (i = 0; i < nChanges; i++) {
+		c = s->changes + i;
+		c->start = posAfterDelete(c->start, start, end);
+		c->end = posAfterDelete(c->end, start, end);
+	}
+}
+
 void uiFreeAttributedString(uiAttributedString *s)
 {
 	uiprivFreeAttrList(s->attrs);
@@ -219,6 +277,11 @@ void uiAttributedStringInsertAtUnattributed(uiAttributedString *s, const char *s
 
 	// and finally do the attributes
 	uiprivAttrListInsertCharactersUnattributed(s->attrs, at, n8);
+
+	if (oldn8 != 0) {
+		shiftChangesForInsert(s, at, oldn8);
+		recordChange(s, at, at + oldn8);
+	}
 }
 
 // TODO document that end is the first index that will be maintained
@@ -277,11 +340,44 @@ void uiAttributedStringDelete(uiAttributedString *s, size_t start, size_t end)
 
 	// and finally resize
 	resize(s, s->len - count, s->u16len - count16);
+	if (count != 0) {
+		shiftChangesForDelete(s, start, end);
+		recordChange(s, start, start);
+	}
 }
 
 void uiAttributedStringSetAttribute(uiAttributedString *s, uiAttribute *a, size_t start, size_t end)
 {
 	uiprivAttrListInsertAttribute(s->attrs, a, start, end);
+	recordChange(s, start, end);
+}
+
+void uiAttributedStringSetAttributesBulk(uiAttributedString *s, const uiAttributeRun *runs, size_t n)
+{
+	size_t lastEnd[uiAttributeTypeFeatures + 1];
+	uiAttributeType type;
+	size_t end;
+	size_t i;
+
+	if (n == 0)
+		return;
+	memset(lastEnd, 0, sizeof (lastEnd));
+	end = 0;
+	for (i = 0; i < n; i++) {
+		if (runs[i].Start > runs[i].End)
+			uiprivUserBug("You cannot give a uiAttributeRun a start after its end. (run: %lu; start: %lu; end: %lu)", (unsigned long) i, (unsigned long) (runs[i].Start), (unsigned long) (runs[i].End));
+		if (i != 0 && runs[i].Start < runs[i - 1].Start)
+			uiprivUserBug("You must sort the uiAttributeRuns given to uiAttributedStringSetAttributesBulk() by start. (run: %lu; start: %lu; previous start: %lu)", (unsigned long) i, (unsigned long) (runs[i].Start), (unsigned long) (runs[i - 1].Start));
+		type = uiAttributeGetType(runs[i].Attribute);
+		if (runs[i].Start < lastEnd[type])
+			uiprivUserBug("You cannot give uiAttributedStringSetAttributesBulk() overlapping uiAttributeRuns of the same type. (run: %lu; start: %lu; previous end: %lu)", (unsigned long) i, (unsigned long) (runs[i].Start), (unsigned long) lastEnd[type]);
+		if (runs[i].Start != runs[i].End)
+			lastEnd[type] = runs[i].End;
+		if (end < runs[i].End)
+			end = runs[i].End;
+	}
+	uiprivAttrListInsertRuns(s->attrs, runs, n);
+	recordChange(s, runs[0].Start, end);
 }
 
 // LONGTERM introduce an iterator object instead?
@@ -290,6 +386,48 @@ void uiAttributedStringForEachAttribute(const uiAttributedString *s, uiAttribute
 	uiprivAttrListForEach(s->attrs, s, f, data);
 }
 
+void uiAttributedStringForEachAttributeInRange(const uiAttributedString *s, size_t start, size_t end, uiAttributedStringForEachAttributeFunc f, void *data)
+{
+	uiprivAttrListForEachInRange(s->attrs, s, start, end, f, data);
+}
+
+void uiAttributedStringAttributesAt(const uiAttributedString *s, size_t pos, uiAttributedStringForEachAttributeFunc f, void *data)
+{
+	uiprivAttrListForEachInRange(s->attrs, s, pos, pos + 1, f, data);
+}
+
+uint64_t uiAttributedStringGeneration(const uiAttributedString *s)
+{
+	return s->generation;
+}
+
+int uiAttributedStringChangedSince(const uiAttributedString *s, uint64_t generation, size_t *start, size_t *end)
+{
+	const struct change *c;
+	uint64_t g;
+
+	if (generation > s->generation)
+		uiprivUserBug("You cannot ask a uiAttributedString about changes since a generation it hasn't reached yet. (string: %p; generation: %llu; current generation: %llu)", s, (unsigned long long) generation, (unsigned long long) (s->generation));
+	if (generation == s->generation)
+		return 0;
+	if (s->generation - generation > nChanges) {
+		*start = 0;
+		*end = s->len;
+		return 1;
+	}
+	c = s->changes + ((generation + 1) % nChanges);
+	*start = c->start;
+	*end = c->end;
+	for (g = generation + 2; g <= s->generation; g++) {
+		c = s->changes + (g % nChanges);
+		if (*start > c->start)
+			*start = c->start;
+		if (*end < c->end)
+			*end = c->end;
+	}
+	return 1;
+}
+
 // TODO figure out if we should count the grapheme past the end
 size_t uiAttributedStringNumGraphemes(uiAttributedString *s)
 {
@@ -314,6 +452,21 @@ size_t uiAttributedStringGraphemeToByteIndex(uiAttributedString *s, size_t pos)
 	return pos;
 }
 
+// creates a new string out of the bytes [start, end) of s, keeping the attributes in that range
+// start and end must be on codepoint boundaries
+uiAttributedString *uiprivNewAttributedSubstring(const uiAttributedString *s, size_t start, size_t end)
+{
+	uiAttributedString *sub;
+	char *str;
+
+	str = (char *) uiprivAlloc((end - start + 1) * sizeof (char), "char[] (uiAttributedString)");
+	memmove(str, s->s + start, (end - start) * sizeof (char));
+	sub = uiNewAttributedString(str);
+	uiprivFree(str);
+	uiprivAttrListCopyRange(sub->attrs, s->attrs, start, end);
+	return sub;
+}
+
 // helpers for platform-specific code
 
 const uint16_t *uiprivAttributedStringUTF16String(const uiAttributedString *s)
@@ -8,9 +8,15 @@ extern "C" {
 extern uiAttribute *uiprivAttributeRetain(uiAttribute *a);
 extern void uiprivAttributeRelease(uiAttribute *a);
 extern int uiprivAttributeEqual(const uiAttribute *a, const uiAttribute *b);
+extern size_t uiprivAttributeHash(const uiAttribute *a);
+extern void *uiprivAttributeOSData(const uiAttribute *a);
+extern void uiprivAttributeSetOSData(const uiAttribute *a, void *data, void (*f)(void *data));
 
 // opentype.c
 extern int uiprivOpenTypeFeaturesEqual(const uiOpenTypeFeatures *a, const uiOpenTypeFeatures *b);
+extern size_t uiprivOpenTypeFeaturesHash(const uiOpenTypeFeatures *otf);
+extern void *uiprivOpenTypeFeaturesOSData(const uiOpenTypeFeatures *otf);
+extern void uiprivOpenTypeFeaturesSetOSData(const uiOpenTypeFeatures *otf, void *data, void (*f)(void *data));
 
 // attrlist.c
 typedef struct uiprivAttrList uiprivAttrList;
@@ -22,9 +28,13 @@ extern void uiprivAttrListInsertCharactersExtendingAttributes(uiprivAttrList *al
 extern void uiprivAttrListRemoveAttribute(uiprivAttrList *alist, uiAttributeType type, size_t start, size_t end);
 extern void uiprivAttrListRemoveAttributes(uiprivAttrList *alist, size_t start, size_t end);
 extern void uiprivAttrListRemoveCharacters(uiprivAttrList *alist, size_t start, size_t end);
+extern void uiprivAttrListCopyRange(uiprivAttrList *dst, const uiprivAttrList *src, size_t start, size_t end);
 extern void uiprivAttrListForEach(const uiprivAttrList *alist, const uiAttributedString *s, uiAttributedStringForEachAttributeFunc f, void *data);
+extern void uiprivAttrListForEachInRange(const uiprivAttrList *alist, const uiAttributedString *s, size_t start, size_t end, uiAttributedStringForEachAttributeFunc f, void *data);
+extern void uiprivAttrListInsertRuns(uiprivAttrList *alist, const uiAttributeRun *runs, size_t n);
 
 // attrstr.c
+extern uiAttributedString *uiprivNewAttributedSubstring(const uiAttributedString *s, size_t start, size_t end);
 extern const uint16_t *uiprivAttributedStringUTF16String(const uiAttributedString *s);
 extern size_t uiprivAttributedStringUTF16Len(const uiAttributedString *s);
 extern size_t uiprivAttributedStringUTF8ToUTF16(const uiAttributedString *s, size_t n);
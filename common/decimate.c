@@ -0,0 +1,144 @@
+// 19 october 2026
+#include <math.h>
+#include "../ui.h"
+#include "uipriv.h"
+
+// This is the M4 algorithm: for each run of consecutive points that land in the same device pixel column, keep only the first, last, topmost, and bottommost points, in their original order.
+// Rasterizing the polyline through those points touches exactly the same pixels in that column as rasterizing the whole run did, and the segments that join one column to the next are unchanged, so for series whose x is monotonic the output draws the same as the input.
+// For other series it is still correct, just less effective, since a run ends every time the line leaves a column.
+
+// inputs smaller than this aren't worth splitting, or handing to other threads
+#define chunkSize 65536
+
+struct decimate {
+	const double *xs;
+	const double *ys;
+	size_t n;
+	uiDrawMatrix m;
+	size_t *indices;
+	size_t *counts;
+};
+
+// emits the kept points of the run [first, last] into out, and returns how many
+static size_t emitRun(size_t *out, size_t first, size_t top, size_t bottom, size_t last)
+{
+	size_t k[4];
+	size_t t;
+	size_t i, j, n;
+
+	k[0] = first;
+	k[1] = top;
+	k[2] = bottom;
+	k[3] = last;
+	// sort the middle two, since first and last are already where they belong
+	if (k[1] > k[2]) {
+		t = k[1];
+		k[1] = k[2];
+		k[2] = t;
+	}
+	n = 0;
+	for (i = 0; i < 4; i++) {
+		for (j = 0; j < n; j++)
+			if (out[j] == k[i])
+				break;
+		if (j == n)
+			out[n++] = k[i];
+	}
+	return n;
+}
+
+// each chunk writes its output over the front of its own slice of indices; that's always big enough, since a run never emits more points than it has
+static void decimateChunk(void *data, size_t chunk)
+{
+	struct decimate *d = (struct decimate *) data;
+	size_t start, end;
+	size_t *out;
+	size_t n;
+	size_t i;
+	size_t first, top, bottom;
+	double col, x, y, topY, bottomY;
+
+	start = chunk * chunkSize;
+	end = start + chunkSize;
+	if (end > d->n)
+		end = d->n;
+	out = d->indices + start;
+	n = 0;
+
+	first = top = bottom = start;
+	col = 0;
+	topY = bottomY = 0;
+	for (i = start; i < end; i++) {
+		x = d->m.M11 * d->xs[i] + d->m.M21 * d->ys[i] + d->m.M31;
+		y = d->m.M12 * d->xs[i] + d->m.M22 * d->ys[i] + d->m.M32;
+		x = floor(x);
+		// NaNs never compare equal, so they always end up in runs of their own
+		if (i != start && x == col) {
+			if (y < topY) {
+				top = i;
+				topY = y;
+			}
+			if (y > bottomY) {
+				bottom = i;
+				bottomY = y;
+			}
+			continue;
+		}
+		if (i != start)
+			n += emitRun(out + n, first, top, bottom, i - 1);
+		col = x;
+		first = top = bottom = i;
+		topY = bottomY = y;
+	}
+	if (end != start)
+		n += emitRun(out + n, first, top, bottom, end - 1);
+	d->counts[chunk] = n;
+}
+
+size_t uiDrawDecimatePolyline(const double *xs, const double *ys, size_t n, const uiDrawMatrix *m, size_t *indices)
+{
+	struct decimate d;
+	size_t nChunks;
+	size_t i, out;
+
+	if (n == 0)
+		return 0;
+	d.xs = xs;
+	d.ys = ys;
+	d.n = n;
+	if (m != NULL)
+		d.m = *m;
+	else
+		uiDrawMatrixSetIdentity(&(d.m));
+	d.indices = indices;
+	nChunks = (n + chunkSize - 1) / chunkSize;
+	d.counts = (size_t *) uiprivAlloc(nChunks * sizeof (size_t), "size_t[]");
+	if (nChunks == 1)
+		decimateChunk(&d, 0);
+	else
+		uiprivParallelFor(nChunks, decimateChunk, &d);
+
+	// and pack the chunks' outputs together
+	out = d.counts[0];
+	for (i = 1; i < nChunks; i++) {
+		memmove(indices + out, indices + i * chunkSize, d.counts[i] * sizeof (size_t));
+		out += d.counts[i];
+	}
+	uiprivFree(d.counts);
+	return out;
+}
+
+void uiDrawPathAddPolyline(uiDrawPath *p, const double *xs, const double *ys, size_t n, const uiDrawMatrix *m)
+{
+	size_t *indices;
+	size_t i, nOut;
+
+	if (n == 0)
+		return;
+	indices = (size_t *) uiprivAlloc(n * sizeof (size_t), "size_t[]");
+	nOut = uiDrawDecimatePolyline(xs, ys, n, m, indices);
+	uiDrawPathNewFigure(p, xs[indices[0]], ys[indices[0]]);
+	for (i = 1; i < nOut; i++)
+		uiDrawPathLineTo(p, xs[indices[i]], ys[indices[i]]);
+	uiprivFree(indices);
+}
@@ -0,0 +1,425 @@
+// 19 october 2026
+#include <math.h>
+#include "../ui.h"
+#include "uipriv.h"
+#include "attrstr.h"
+
+/*
+A uiDrawTextDocument is an array of paragraphs, each of which is a range of bytes of the string ending just after a newline (or at the end of the string).
+Each paragraph only gets a uiDrawTextLayout when it is drawn; until then, its height is estimated from its length.
+To keep lookups logarithmic, the paragraph lengths and heights are not stored as running offsets; instead, they are kept in two Fenwick trees (binary indexed trees), so that the start or top of any paragraph, the paragraph containing a byte, and the paragraph containing a y position can all be found in O(log n), and changing the length or height of a single paragraph is also O(log n).
+Only adding or removing paragraphs (that is, typing or deleting a newline) needs the arrays and the trees to be rebuilt, which is linear but does not lay anything out.
+Layouts are kept for the paragraphs near the ones last drawn, and freed once they scroll far enough away, so the memory used does not grow with the size of the document.
+*/
+
+struct para {
+	size_t len;
+	double height;
+	uiDrawTextLayout *tl;
+};
+
+struct uiDrawTextDocument {
+	uiDrawTextLayoutParams params;
+
+	struct para *paras;
+	size_t n;
+	size_t cap;
+	// both 1-based, as is traditional for Fenwick trees
+	size_t *lenTree;
+	double *heightTree;
+
+	// for estimating the height of paragraphs that haven't been laid out
+	double lineHeight;
+	double charWidth;
+
+	// indices of the paragraphs that currently have layouts
+	size_t *live;
+	size_t nLive;
+	size_t liveCap;
+};
+
+// how many paragraphs on either side of the visible ones keep their layouts
+#define keepMargin 64
+
+// Fenwick trees
+
+static void lenTreeAdd(uiDrawTextDocument *d, size_t i, size_t oldLen, size_t newLen)
+{
+	for (i++; i <= d->n; i += i & (~i + 1)) {
+		d->lenTree[i] -= oldLen;
+		d->lenTree[i] += newLen;
+	}
+}
+
+static void heightTreeAdd(uiDrawTextDocument *d, size_t i, double delta)
+{
+	for (i++; i <= d->n; i += i & (~i + 1))
+		d->heightTree[i] += delta;
+}
+
+// the sum of the lengths of paragraphs [0, i)
+static size_t lenTreePrefix(uiDrawTextDocument *d, size_t i)
+{
+	size_t sum = 0;
+
+	for (; i > 0; i -= i & (~i + 1))
+		sum += d->lenTree[i];
+	return sum;
+}
+
+static double heightTreePrefix(uiDrawTextDocument *d, size_t i)
+{
+	double sum = 0;
+
+	for (; i > 0; i -= i & (~i + 1))
+		sum += d->heightTree[i];
+	return sum;
+}
+
+static size_t highBit(size_t n)
+{
+	size_t bit = 1;
+
+	while (bit <= n / 2)
+		bit <<= 1;
+	return bit;
+}
+
+// returns the paragraph containing byte pos; a pos at or past the end returns the last paragraph
+static size_t paraForByte(uiDrawTextDocument *d, size_t pos)
+{
+	size_t i, bit;
+
+	// standard Fenwick descent: find the largest i such that the first i paragraphs end at or before pos
+	i = 0;
+	for (bit = highBit(d->n); bit != 0; bit >>= 1)
+		if (i + bit <= d->n && d->lenTree[i + bit] <= pos) {
+			i += bit;
+			pos -= d->lenTree[i];
+		}
+	if (i >= d->n)
+		i = d->n - 1;
+	return i;
+}
+
+// same as above, but for y positions; a y past the end returns the last paragraph
+static size_t paraForY(uiDrawTextDocument *d, double y)
+{
+	size_t i, bit;
+
+	if (y < 0)
+		return 0;
+	i = 0;
+	for (bit = highBit(d->n); bit != 0; bit >>= 1)
+		if (i + bit <= d->n && d->heightTree[i + bit] <= y) {
+			i += bit;
+			y -= d->heightTree[i];
+		}
+	if (i >= d->n)
+		i = d->n - 1;
+	return i;
+}
+
+// builds both trees from scratch in O(n)
+static void rebuildTrees(uiDrawTextDocument *d)
+{
+	size_t i, j;
+
+	d->lenTree = (size_t *) uiprivRealloc(d->lenTree, (d->n + 1) * sizeof (size_t), "size_t[] (uiDrawTextDocument)");
+	d->heightTree = (double *) uiprivRealloc(d->heightTree, (d->n + 1) * sizeof (double), "double[] (uiDrawTextDocument)");
+	d->lenTree[0] = 0;
+	d->heightTree[0] = 0;
+	for (i = 1; i <= d->n; i++) {
+		d->lenTree[i] = d->paras[i - 1].len;
+		d->heightTree[i] = d->paras[i - 1].height;
+	}
+	for (i = 1; i <= d->n; i++) {
+		j = i + (i & (~i + 1));
+		if (j <= d->n) {
+			d->lenTree[j] += d->lenTree[i];
+			d->heightTree[j] += d->heightTree[i];
+		}
+	}
+}
+
+// paragraphs
+
+static double estimateHeight(uiDrawTextDocument *d, size_t len)
+{
+	double lines;
+
+	lines = 1;
+	if (d->params.Width > 0) {
+		lines = ceil(((double) len * d->charWidth) / d->params.Width);
+		if (lines < 1)
+			lines = 1;
+	}
+	return lines * d->lineHeight;
+}
+
+// not counting the newline (and any carriage return before it), which would otherwise add an empty line to the end of the paragraph's layout
+static size_t paraTextLen(const char *s, size_t start, size_t len)
+{
+	if (len > 0 && s[start + len - 1] == '\n') {
+		len--;
+		if (len > 0 && s[start + len - 1] == '\r')
+			len--;
+	}
+	return len;
+}
+
+static void freeLayout(struct para *p)
+{
+	if (p->tl == NULL)
+		return;
+	uiDrawFreeTextLayout(p->tl);
+	p->tl = NULL;
+}
+
+static void addLive(uiDrawTextDocument *d, size_t i)
+{
+	if (d->nLive == d->liveCap) {
+		d->liveCap += 32;
+		d->live = (size_t *) uiprivRealloc(d->live, d->liveCap * sizeof (size_t), "size_t[] (uiDrawTextDocument)");
+	}
+	d->live[d->nLive] = i;
+	d->nLive++;
+}
+
+// lays out paragraph i, whose text starts at start, if it isn't already, and updates its height
+static void layoutPara(uiDrawTextDocument *d, size_t i, size_t start)
+{
+	struct para *p = &(d->paras[i]);
+	uiAttributedString *sub;
+	uiDrawTextLayoutParams lp;
+	double width, height;
+
+	if (p->tl != NULL)
+		return;
+	sub = uiprivNewAttributedSubstring(d->params.String, start,
+		start + paraTextLen(uiAttributedStringString(d->params.String), start, p->len));
+	lp = d->params;
+	lp.String = sub;
+	p->tl = uiDrawNewTextLayout(&lp);
+	// the layout does not reference the string after it has been created
+	uiFreeAttributedString(sub);
+	addLive(d, i);
+
+	uiDrawTextLayoutExtents(p->tl, &width, &height);
+	if (height != p->height)
+		heightTreeAdd(d, i, height - p->height);
+	p->height = height;
+}
+
+// frees the layouts of paragraphs outside [first, last]
+static void pruneLive(uiDrawTextDocument *d, size_t first, size_t last)
+{
+	size_t i, j;
+
+	j = 0;
+	for (i = 0; i < d->nLive; i++) {
+		if (d->live[i] >= first && d->live[i] <= last) {
+			d->live[j] = d->live[i];
+			j++;
+			continue;
+		}
+		freeLayout(&(d->paras[d->live[i]]));
+	}
+	d->nLive = j;
+}
+
+static void freeAllLayouts(uiDrawTextDocument *d)
+{
+	size_t i;
+
+	for (i = 0; i < d->nLive; i++)
+		freeLayout(&(d->paras[d->live[i]]));
+	d->nLive = 0;
+}
+
+// frees the layouts of paragraphs [first, last], which are about to be replaced by n new paragraphs, and moves the live indices after them accordingly
+static void replaceLive(uiDrawTextDocument *d, size_t first, size_t last, size_t n)
+{
+	size_t i, j;
+
+	j = 0;
+	for (i = 0; i < d->nLive; i++) {
+		if (d->live[i] >= first && d->live[i] <= last) {
+			freeLayout(&(d->paras[d->live[i]]));
+			continue;
+		}
+		d->live[j] = d->live[i];
+		if (d->live[j] > last)
+			d->live[j] = d->live[j] - (last - first + 1) + n;
+		j++;
+	}
+	d->nLive = j;
+}
+
+static void appendPara(uiDrawTextDocument *d, struct para **out, size_t *n, size_t *cap, size_t len)
+{
+	if (*n == *cap) {
+		*cap *= 2;
+		*out = (struct para *) uiprivRealloc(*out, *cap * sizeof (struct para), "struct para[] (uiDrawTextDocument)");
+	}
+	(*out)[*n].len = len;
+	(*out)[*n].height = estimateHeight(d, len);
+	(*out)[*n].tl = NULL;
+	(*n)++;
+}
+
+// splits the bytes [start, end) of the string into paragraphs and returns them in a newly allocated array
+// end is either the end of the string or just after a newline
+static struct para *splitParas(uiDrawTextDocument *d, size_t start, size_t end, size_t *n)
+{
+	const char *s;
+	struct para *out;
+	size_t cap;
+	size_t i, pstart;
+
+	s = uiAttributedStringString(d->params.String);
+	cap = 16;
+	out = (struct para *) uiprivAlloc(cap * sizeof (struct para), "struct para[] (uiDrawTextDocument)");
+	*n = 0;
+	pstart = start;
+	for (i = start; i < end; i++)
+		if (s[i] == '\n') {
+			appendPara(d, &out, n, &cap, i + 1 - pstart);
+			pstart = i + 1;
+		}
+	// the end of the string always ends a paragraph, even an empty one; that is how empty documents and documents that end in a newline get their last line
+	if (pstart != end || end == uiAttributedStringLen(d->params.String) || *n == 0)
+		appendPara(d, &out, n, &cap, end - pstart);
+	return out;
+}
+
+static void measureEstimates(uiDrawTextDocument *d)
+{
+	uiAttributedString *sample;
+	uiDrawTextLayoutParams lp;
+	uiDrawTextLayout *tl;
+	double width, height;
+	static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz";
+
+	sample = uiNewAttributedString(alphabet);
+	lp = d->params;
+	lp.String = sample;
+	lp.Width = -1;
+	tl = uiDrawNewTextLayout(&lp);
+	uiDrawTextLayoutExtents(tl, &width, &height);
+	uiDrawFreeTextLayout(tl);
+	uiFreeAttributedString(sample);
+	d->lineHeight = height;
+	d->charWidth = width / (sizeof (alphabet) - 1);
+}
+
+uiDrawTextDocument *uiDrawNewTextDocument(uiDrawTextLayoutParams *params)
+{
+	uiDrawTextDocument *d;
+
+	d = uiprivNew(uiDrawTextDocument);
+	d->params = *params;
+	measureEstimates(d);
+	d->paras = splitParas(d, 0, uiAttributedStringLen(d->params.String), &(d->n));
+	d->cap = d->n;
+	rebuildTrees(d);
+	return d;
+}
+
+void uiDrawFreeTextDocument(uiDrawTextDocument *d)
+{
+	freeAllLayouts(d);
+	if (d->live != NULL)
+		uiprivFree(d->live);
+	uiprivFree(d->heightTree);
+	uiprivFree(d->lenTree);
+	uiprivFree(d->paras);
+	uiprivFree(d);
+}
+
+void uiDrawTextDocumentDraw(uiAreaDrawParams *p, uiDrawTextDocument *d, double x, double y)
+{
+	double top, bottom;
+	double paraTop;
+	size_t i, first;
+	size_t start;
+
+	top = p->ClipY - y;
+	bottom = top + p->ClipHeight;
+	first = paraForY(d, top);
+	start = lenTreePrefix(d, first);
+	paraTop = heightTreePrefix(d, first);
+	// laying out a paragraph can change its height, but only after paraTop has already been computed from it, so the next paragraph still starts in the right place
+	for (i = first; i < d->n; i++) {
+		if (paraTop >= bottom)
+			break;
+		layoutPara(d, i, start);
+		uiDrawText(p->Context, d->paras[i].tl, x, y + paraTop);
+		paraTop += d->paras[i].height;
+		start += d->paras[i].len;
+	}
+	if (i != 0)
+		i--;
+	pruneLive(d,
+		(first > keepMargin) ? (first - keepMargin) : 0,
+		i + keepMargin);
+}
+
+double uiDrawTextDocumentHeight(uiDrawTextDocument *d)
+{
+	return heightTreePrefix(d, d->n);
+}
+
+void uiDrawTextDocumentSetWidth(uiDrawTextDocument *d, double width)
+{
+	size_t i;
+
+	if (d->params.Width == width)
+		return;
+	d->params.Width = width;
+	freeAllLayouts(d);
+	for (i = 0; i < d->n; i++)
+		d->paras[i].height = estimateHeight(d, d->paras[i].len);
+	rebuildTrees(d);
+}
+
+void uiDrawTextDocumentRangeChanged(uiDrawTextDocument *d, size_t start, size_t oldEnd, size_t newEnd)
+{
+	size_t first, last;
+	size_t firstStart, lastEnd;
+	struct para *repl;
+	size_t nRepl, nOld;
+
+	first = paraForByte(d, start);
+	// a change that ends exactly at the start of a paragraph may have removed the newline before it, so that paragraph has to be split again too
+	last = paraForByte(d, oldEnd);
+	firstStart = lenTreePrefix(d, first);
+	lastEnd = lenTreePrefix(d, last + 1);
+	nOld = last - first + 1;
+
+	// the new text may contain newlines, so split the whole region again; that's only linear in the size of the affected paragraphs
+	repl = splitParas(d, firstStart, lastEnd - oldEnd + newEnd, &nRepl);
+	replaceLive(d, first, last, nRepl);
+
+	// the common case: typing or changing attributes within a paragraph without adding or removing newlines
+	if (nRepl == 1 && nOld == 1) {
+		lenTreeAdd(d, first, d->paras[first].len, repl[0].len);
+		heightTreeAdd(d, first, repl[0].height - d->paras[first].height);
+		d->paras[first] = repl[0];
+		uiprivFree(repl);
+		return;
+	}
+
+	// otherwise splice the new paragraphs in and rebuild the trees
+	if (d->n - nOld + nRepl > d->cap) {
+		d->cap = d->n - nOld + nRepl;
+		d->paras = (struct para *) uiprivRealloc(d->paras, d->cap * sizeof (struct para), "struct para[] (uiDrawTextDocument)");
+	}
+	memmove(d->paras + first + nRepl,
+		d->paras + last + 1,
+		(d->n - last - 1) * sizeof (struct para));
+	memmove(d->paras + first, repl, nRepl * sizeof (struct para));
+	d->n = d->n - nOld + nRepl;
+	uiprivFree(repl);
+	rebuildTrees(d);
+}
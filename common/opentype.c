@@ -4,11 +4,12 @@
 #include "uipriv.h"
 #include "attrstr.h"
 
+// Features are stored as their tags packed into a uint32_t, most significant byte first, so comparing tags is comparing integers and sorting by tag sorts them the same way as comparing the characters in order would.
+// The array is kept in whatever order things were added in; it is only sorted when something needs a canonical order (enumeration, hashing, comparison), and stays sorted until the next new tag or removal.
+// Small sets are searched linearly; once a set is big enough, lookups go through a hash table of positions in the array instead. That table is built on demand and thrown away whenever the positions change.
+
 struct feature {
-	char a;
-	char b;
-	char c;
-	char d;
+	uint32_t tag;
 	uint32_t value;
 };
 
@@ -16,10 +17,30 @@ struct uiOpenTypeFeatures {
 	struct feature *data;
 	size_t len;
 	size_t cap;
+	int sorted;
+
+	// each slot is an index into data plus 1, or 0 if empty
+	size_t *slots;
+	size_t nSlots;		// always a power of 2; 0 if there's no table right now
+
+	// the OS-specific code can cache its own conversion of the features here; see uiprivOpenTypeFeaturesSetOSData()
+	void *osData;
+	void (*freeOSData)(void *osData);
 };
 
 #define bytecount(n) ((n) * sizeof (struct feature))
 
+// below this many features, a linear search of the packed tags is faster than hashing
+#define hashThreshold 32
+
+static uint32_t mktag(char a, char b, char c, char d)
+{
+	return (((uint32_t) (uint8_t) a) << 24) |
+		(((uint32_t) (uint8_t) b) << 16) |
+		(((uint32_t) (uint8_t) c) << 8) |
+		((uint32_t) (uint8_t) d);
+}
+
 uiOpenTypeFeatures *uiNewOpenTypeFeatures(void)
 {
 	uiOpenTypeFeatures *otf;
@@ -28,11 +49,31 @@ uiOpenTypeFeatures *uiNewOpenTypeFeatures(void)
 	otf->cap = 16;
 	otf->data = (struct feature *) uiprivAlloc(bytecount(otf->cap), "struct feature[]");
 	otf->len = 0;
+	otf->sorted = 1;
 	return otf;
 }
 
+static void freeSlots(uiOpenTypeFeatures *otf)
+{
+	if (otf->nSlots == 0)
+		return;
+	uiprivFree(otf->slots);
+	otf->slots = NULL;
+	otf->nSlots = 0;
+}
+
+static void freeOSData(uiOpenTypeFeatures *otf)
+{
+	if (otf->freeOSData != NULL)
+		(*(otf->freeOSData))(otf->osData);
+	otf->osData = NULL;
+	otf->freeOSData = NULL;
+}
+
 void uiFreeOpenTypeFeatures(uiOpenTypeFeatures *otf)
 {
+	freeOSData(otf);
+	freeSlots(otf);
 	uiprivFree(otf->data);
 	uiprivFree(otf);
 }
@@ -45,97 +86,150 @@ uiOpenTypeFeatures *uiOpenTypeFeaturesClone(const uiOpenTypeFeatures *otf)
 	ret->len = otf->len;
 	ret->cap = otf->cap;
 	ret->data = (struct feature *) uiprivAlloc(bytecount(ret->cap), "struct feature[]");
-	memset(ret->data, 0, bytecount(ret->cap));
 	memmove(ret->data, otf->data, bytecount(ret->len));
+	ret->sorted = otf->sorted;
 	return ret;
 }
 
-#define intdiff(a, b) (((int) (a)) - ((int) (b)))
+static size_t hashTag(uint32_t tag)
+{
+	// the low bytes of tags are often the same few letters, so mix everything down
+	tag ^= tag >> 16;
+	tag *= 0x45D9F3Bu;
+	tag ^= tag >> 16;
+	return (size_t) tag;
+}
+
+static size_t *findSlot(const uiOpenTypeFeatures *otf, uint32_t tag)
+{
+	size_t i;
+
+	i = hashTag(tag) & (otf->nSlots - 1);
+	while (otf->slots[i] != 0 && otf->data[otf->slots[i] - 1].tag != tag)
+		i = (i + 1) & (otf->nSlots - 1);
+	return otf->slots + i;
+}
+
+static void buildSlots(uiOpenTypeFeatures *otf)
+{
+	size_t i;
+
+	freeSlots(otf);
+	// keep the load factor at or under 1/2, with room to grow before the next rebuild
+	otf->nSlots = 64;
+	while (otf->nSlots < otf->cap * 2)
+		otf->nSlots *= 2;
+	otf->slots = (size_t *) uiprivAlloc(otf->nSlots * sizeof (size_t), "size_t[] (uiOpenTypeFeatures)");
+	for (i = 0; i < otf->len; i++)
+		*findSlot(otf, otf->data[i].tag) = i + 1;
+}
+
+// returns the position of tag in otf->data, or otf->len if it isn't there
+// this is allowed on const features since the table is just a cache
+static size_t find(const uiOpenTypeFeatures *otf, uint32_t tag)
+{
+	uiOpenTypeFeatures *m = (uiOpenTypeFeatures *) otf;
+	size_t i;
+
+	if (otf->len < hashThreshold) {
+		for (i = 0; i < otf->len; i++)
+			if (otf->data[i].tag == tag)
+				return i;
+		return otf->len;
+	}
+	if (otf->nSlots == 0)
+		buildSlots(m);
+	i = *findSlot(otf, tag);
+	if (i == 0)
+		return otf->len;
+	return i - 1;
+}
 
 static int featurecmp(const void *a, const void *b)
 {
 	const struct feature *f = (const struct feature *) a;
 	const struct feature *g = (const struct feature *) b;
 
-	if (f->a != g->a)
-		return intdiff(f->a, g->a);
-	if (f->b != g->b)
-		return intdiff(f->b, g->b);
-	if (f->c != g->c)
-		return intdiff(f->c, g->c);
-	return intdiff(f->d, g->d);
+	if (f->tag < g->tag)
+		return -1;
+	if (f->tag > g->tag)
+		return 1;
+	return 0;
 }
 
-static struct feature mkkey(char a, char b, char c, char d)
+// this is allowed on const features since it doesn't change what's in the set
+static void ensureSorted(const uiOpenTypeFeatures *otf)
 {
-	struct feature f;
+	uiOpenTypeFeatures *m = (uiOpenTypeFeatures *) otf;
 
-	f.a = a;
-	f.b = b;
-	f.c = c;
-	f.d = d;
-	return f;
+	if (otf->sorted)
+		return;
+	qsort(m->data, m->len, sizeof (struct feature), featurecmp);
+	m->sorted = 1;
+	freeSlots(m);
 }
 
-#define find(pkey, otf) bsearch(pkey, otf->data, otf->len, sizeof (struct feature), featurecmp)
-
 void uiOpenTypeFeaturesAdd(uiOpenTypeFeatures *otf, char a, char b, char c, char d, uint32_t value)
 {
 	struct feature *f;
-	struct feature key;
+	uint32_t tag;
+	size_t i;
 
 	// replace existing value if any
-	key = mkkey(a, b, c, d);
-	f = (struct feature *) find(&key, otf);
-	if (f != NULL) {
-		f->value = value;
+	tag = mktag(a, b, c, d);
+	i = find(otf, tag);
+	if (i != otf->len) {
+		if (otf->data[i].value != value) {
+			freeOSData(otf);
+			otf->data[i].value = value;
+		}
 		return;
 	}
+	freeOSData(otf);
 
 	// if we got here, the tag is new
 	if (otf->len == otf->cap) {
 		otf->cap *= 2;
 		otf->data = (struct feature *) uiprivRealloc(otf->data, bytecount(otf->cap), "struct feature[]");
+		// the table was sized for the old capacity
+		freeSlots(otf);
 	}
 	f = otf->data + otf->len;
-	f->a = a;
-	f->b = b;
-	f->c = c;
-	f->d = d;
+	f->tag = tag;
 	f->value = value;
-	// LONGTERM qsort here is overkill
+	if (otf->len != 0 && otf->data[otf->len - 1].tag > tag)
+		otf->sorted = 0;
 	otf->len++;
-	qsort(otf->data, otf->len, sizeof (struct feature), featurecmp);
+	if (otf->nSlots != 0)
+		*findSlot(otf, tag) = otf->len;
 }
 
 void uiOpenTypeFeaturesRemove(uiOpenTypeFeatures *otf, char a, char b, char c, char d)
 {
-	struct feature *f;
-	struct feature key;
-	ptrdiff_t index;
-	size_t count;
+	size_t i;
 
-	key = mkkey(a, b, c, d);
-	f = (struct feature *) find(&key, otf);
-	if (f == NULL)
+	i = find(otf, mktag(a, b, c, d));
+	if (i == otf->len)
 		return;
-
-	index = f - otf->data;
-	count = otf->len - index - 1;
-	memmove(f + 1, f, bytecount(count));
+	freeOSData(otf);
+	// move the last one into the hole instead of shifting everything after it down
 	otf->len--;
+	if (i != otf->len) {
+		otf->data[i] = otf->data[otf->len];
+		otf->sorted = 0;
+	}
+	// linear probing doesn't make deleting from the table easy, so just start over next time
+	freeSlots(otf);
 }
 
 int uiOpenTypeFeaturesGet(const uiOpenTypeFeatures *otf, char a, char b, char c, char d, uint32_t *value)
 {
-	const struct feature *f;
-	struct feature key;
+	size_t i;
 
-	key = mkkey(a, b, c, d);
-	f = (const struct feature *) find(&key, otf);
-	if (f == NULL)
+	i = find(otf, mktag(a, b, c, d));
+	if (i == otf->len)
 		return 0;
-	*value = f->value;
+	*value = otf->data[i].value;
 	return 1;
 }
 
@@ -145,9 +239,15 @@ void uiOpenTypeFeaturesForEach(const uiOpenTypeFeatures *otf, uiOpenTypeFeatures
 	const struct feature *p;
 	uiForEach ret;
 
+	ensureSorted(otf);
 	p = otf->data;
 	for (n = 0; n < otf->len; n++) {
-		ret = (*f)(otf, p->a, p->b, p->c, p->d, p->value, data);
+		ret = (*f)(otf,
+			(char) (p->tag >> 24),
+			(char) ((p->tag >> 16) & 0xFF),
+			(char) ((p->tag >> 8) & 0xFF),
+			(char) (p->tag & 0xFF),
+			p->value, data);
 		// TODO for all: require exact match?
 		if (ret == uiForEachStop)
 			return;
@@ -155,11 +255,45 @@ void uiOpenTypeFeaturesForEach(const uiOpenTypeFeatures *otf, uiOpenTypeFeatures
 	}
 }
 
+size_t uiprivOpenTypeFeaturesHash(const uiOpenTypeFeatures *otf)
+{
+	const uint8_t *b;
+	size_t i, h;
+
+	// FNV-1a over the sorted feature list, so equal feature sets hash the same
+	ensureSorted(otf);
+	h = (size_t) 2166136261u;
+	b = (const uint8_t *) (otf->data);
+	for (i = 0; i < bytecount(otf->len); i++) {
+		h ^= b[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+
 int uiprivOpenTypeFeaturesEqual(const uiOpenTypeFeatures *a, const uiOpenTypeFeatures *b)
 {
 	if (a == b)
 		return 1;
 	if (a->len != b->len)
 		return 0;
+	ensureSorted(a);
+	ensureSorted(b);
 	return memcmp(a->data, b->data, bytecount(a->len)) == 0;
 }
+
+void *uiprivOpenTypeFeaturesOSData(const uiOpenTypeFeatures *otf)
+{
+	return otf->osData;
+}
+
+// the cached data is freed with f when otf is changed or destroyed
+// this is allowed on const features since it doesn't change what's in the set
+void uiprivOpenTypeFeaturesSetOSData(const uiOpenTypeFeatures *otf, void *data, void (*f)(void *data))
+{
+	uiOpenTypeFeatures *m = (uiOpenTypeFeatures *) otf;
+
+	freeOSData(m);
+	m->osData = data;
+	m->freeOSData = f;
+}
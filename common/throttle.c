@@ -0,0 +1,150 @@
+// 19 october 2026
+#include <stdio.h>
+#include <stdlib.h>
+#include "../ui.h"
+#include "uipriv.h"
+
+// A uiprivThrottle sits between a control's OS change signal and its On...Changed() handler and decides when the handler runs, according to a uiChangePolicy.
+// It is built only on uiQueueMain() and uiTimer(), so every OS gets it for free; neither of those can be cancelled, though, so a throttle freed while one of them is pending is only marked dead, and the last pending callback frees it.
+// That can happen after uiUninit() (a debounced control destroyed just before quitting, say), which is why this uses malloc() instead of uiprivAlloc().
+
+struct uiprivThrottle {
+	void (*fire)(void *data);
+	void *data;
+	uiChangePolicy policy;
+	int milliseconds;
+	// a change came in that the handler hasn't been told about yet
+	int dirty;
+	int queued;		// a uiQueueMain() is pending
+	int timing;		// a uiTimer() is pending
+	int dead;
+};
+
+uiprivThrottle *uiprivNewThrottle(void (*fire)(void *data), void *data)
+{
+	uiprivThrottle *t;
+
+	t = (uiprivThrottle *) calloc(1, sizeof (uiprivThrottle));
+	if (t == NULL) {
+		fprintf(stderr, "memory exhausted in uiprivNewThrottle()\n");
+		abort();
+	}
+	t->fire = fire;
+	t->data = data;
+	t->policy = uiChangePolicyImmediate;
+	return t;
+}
+
+// returns nonzero if t was freed
+static int maybeFree(uiprivThrottle *t)
+{
+	if (t->dead && !t->queued && !t->timing) {
+		free(t);
+		return 1;
+	}
+	return 0;
+}
+
+void uiprivFreeThrottle(uiprivThrottle *t)
+{
+	t->dead = 1;
+	maybeFree(t);
+}
+
+static void fire(uiprivThrottle *t)
+{
+	t->dirty = 0;
+	(*(t->fire))(t->data);
+}
+
+static void onQueued(void *data)
+{
+	uiprivThrottle *t = (uiprivThrottle *) data;
+
+	t->queued = 0;
+	if (maybeFree(t))
+		return;
+	if (t->dirty)
+		fire(t);
+}
+
+// for uiChangePolicyThrottle, the timer marks the end of the period after each call of the handler during which it won't be called again; if anything changed during that period, the handler is called at the end of it and a new period starts
+// for uiChangePolicyDebounce, the timer ticks every t->milliseconds for as long as changes keep coming in, and the handler is called on the first tick that had no changes since the last one; the quiet period before the handler is called is thus between one and two times t->milliseconds
+// in both cases, when a tick finds nothing to do, the timer stops
+static int onTimer(void *data)
+{
+	uiprivThrottle *t = (uiprivThrottle *) data;
+
+	if (t->dead) {
+		t->timing = 0;
+		maybeFree(t);
+		return 0;
+	}
+	switch (t->policy) {
+	case uiChangePolicyThrottle:
+		if (t->dirty) {
+			fire(t);
+			return 1;
+		}
+		break;
+	case uiChangePolicyDebounce:
+		if (t->dirty) {
+			// changed since the last tick, so wait for another
+			t->dirty = 0;
+			return 1;
+		}
+		fire(t);
+		break;
+	default:
+		// the policy changed while we were waiting; let the next change start over
+		if (t->dirty)
+			fire(t);
+		break;
+	}
+	t->timing = 0;
+	// in case the handler destroyed the control
+	maybeFree(t);
+	return 0;
+}
+
+void uiprivThrottleNotify(uiprivThrottle *t)
+{
+	switch (t->policy) {
+	case uiChangePolicyImmediate:
+		fire(t);
+		return;
+	case uiChangePolicyPerFrame:
+		t->dirty = 1;
+		if (!t->queued) {
+			t->queued = 1;
+			uiQueueMain(onQueued, t);
+		}
+		return;
+	case uiChangePolicyDebounce:
+		t->dirty = 1;
+		if (!t->timing) {
+			t->timing = 1;
+			uiTimer(t->milliseconds, onTimer, t);
+		}
+		return;
+	case uiChangePolicyThrottle:
+		if (t->timing) {
+			t->dirty = 1;
+			return;
+		}
+		// start the timer first, so t stays alive if the handler destroys the control
+		t->timing = 1;
+		uiTimer(t->milliseconds, onTimer, t);
+		fire(t);
+		return;
+	}
+}
+
+void uiprivThrottleSetPolicy(uiprivThrottle *t, uiChangePolicy policy, int milliseconds)
+{
+	if (policy == uiChangePolicyDebounce || policy == uiChangePolicyThrottle)
+		if (milliseconds <= 0)
+			uiprivUserBug("You must give a positive number of milliseconds for uiChangePolicyDebounce and uiChangePolicyThrottle. (milliseconds: %d)", milliseconds);
+	t->policy = policy;
+	t->milliseconds = milliseconds;
+}
@@ -18,6 +18,20 @@ extern void *uiprivAlloc(size_t, const char *);
 extern void *uiprivRealloc(void *, size_t, const char *);
 extern void uiprivFree(void *);
 
+// allocstats.c; called by the OS-specific alloc.* files
+extern void uiprivAllocStatsAlloc(const char *type, size_t size);
+extern void uiprivAllocStatsRealloc(const char *type, size_t oldSize, size_t newSize);
+extern void uiprivAllocStatsFree(const char *type, size_t size);
+extern void uiprivUninitAllocStats(void);
+
+// arena.c
+typedef struct uiprivArena uiprivArena;
+extern uiprivArena *uiprivNewArena(void);
+extern void uiprivFreeArena(uiprivArena *a);
+extern void *uiprivArenaAlloc(uiprivArena *a, size_t size);
+extern void *uiprivArenaRealloc(uiprivArena *a, void *p, size_t oldSize, size_t newSize);
+extern void uiprivArenaReset(uiprivArena *a);
+
 // debug.c and OS-specific debug.* files
 // TODO get rid of this mess...
 // ugh, __func__ was only introduced in MSVC 2015...
@@ -34,6 +48,19 @@ extern void uiprivDoImplBug(const char *file, const char *line, const char *func
 extern void uiprivDoUserBug(const char *file, const char *line, const char *func, const char *format, ...);
 #define uiprivUserBug(...) uiprivDoUserBug(__FILE__, uiprivMacro_ns(__LINE__), uiprivMacro__func__, __VA_ARGS__)
 
+// OS-specific parallel.* files
+// calls f(data, i) for each i in [0, n), spread across as many threads as makes sense, and returns when all of them have returned
+// f must not call into libui (other than this) or uiprivAlloc()
+typedef void (*uiprivParallelFunc)(void *data, size_t i);
+extern void uiprivParallelFor(size_t n, uiprivParallelFunc f, void *data);
+
+// throttle.c
+typedef struct uiprivThrottle uiprivThrottle;
+extern uiprivThrottle *uiprivNewThrottle(void (*fire)(void *data), void *data);
+extern void uiprivFreeThrottle(uiprivThrottle *t);
+extern void uiprivThrottleNotify(uiprivThrottle *t);
+extern void uiprivThrottleSetPolicy(uiprivThrottle *t, uiChangePolicy policy, int milliseconds);
+
 // shouldquit.c
 extern int uiprivShouldQuit(void);
 
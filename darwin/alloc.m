@@ -2,12 +2,13 @@
 #import <stdlib.h>
 #import "uipriv_darwin.h"
 
-static NSMutableArray *allocations;
+// a set, so that freeing doesn't have to search every live allocation
+static NSMutableSet *allocations;
 NSMutableArray *uiprivDelegates;
 
 void uiprivInitAlloc(void)
 {
-	allocations = [NSMutableArray new];
+	allocations = [NSMutableSet new];
 	uiprivDelegates = [NSMutableArray new];
 }
 
@@ -26,6 +27,7 @@ void uiprivUninitAlloc(void)
 	NSValue *v;
 
 	[uiprivDelegates release];
+	uiprivUninitAllocStats();
 	if ([allocations count] == 0) {
 		[allocations release];
 		return;
@@ -54,6 +56,7 @@ void *uiprivAlloc(size_t size, const char *type)
 	*SIZE(out) = size;
 	*TYPE(out) = type;
 	[allocations addObject:[NSValue valueWithPointer:out]];
+	uiprivAllocStatsAlloc(type, size);
 	return DATA(out);
 }
 
@@ -71,6 +74,7 @@ void *uiprivRealloc(void *p, size_t new, const char *type)
 		abort();
 	}
 	s = SIZE(out);
+	uiprivAllocStatsRealloc(*TYPE(out), *s, new);
 	if (new > *s)
 		memset(((uint8_t *) DATA(out)) + *s, 0, new - *s);
 	*s = new;
@@ -84,6 +88,7 @@ void uiprivFree(void *p)
 	if (p == NULL)
 		uiprivImplBug("attempt to uiprivFree(NULL)");
 	p = BASE(p);
+	uiprivAllocStatsFree(*TYPE(p), *SIZE(p));
 	free(p);
 	[allocations removeObject:[NSValue valueWithPointer:p]];
 }
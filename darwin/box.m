@@ -467,3 +467,32 @@ uiBox *uiNewVerticalBox(void)
 {
 	return finishNewBox(YES);
 }
+
+// TODO uiVirtualBox is not implemented on macOS yet; the GTK+ version is in unix/virtualbox.c
+
+int uiVirtualBoxNumItems(uiVirtualBox *vb)
+{
+	uiprivImplBug("uiVirtualBoxNumItems() is not implemented on macOS yet");
+	return 0;
+}
+
+void uiVirtualBoxSetNumItems(uiVirtualBox *vb, int n)
+{
+	uiprivImplBug("uiVirtualBoxSetNumItems() is not implemented on macOS yet");
+}
+
+void uiVirtualBoxItemChanged(uiVirtualBox *vb, int index)
+{
+	uiprivImplBug("uiVirtualBoxItemChanged() is not implemented on macOS yet");
+}
+
+void uiVirtualBoxScrollTo(uiVirtualBox *vb, int index)
+{
+	uiprivImplBug("uiVirtualBoxScrollTo() is not implemented on macOS yet");
+}
+
+uiVirtualBox *uiNewVirtualBox(uiVirtualBoxHandler *h, int itemHeight)
+{
+	uiprivImplBug("uiNewVirtualBox() is not implemented on macOS yet");
+	return NULL;
+}
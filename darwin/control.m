@@ -82,3 +82,14 @@ void uiDarwinNotifyVisibilityChanged(uiDarwinControl *c)
 	if (parent != NULL)
 		uiDarwinControlChildVisibilityChanged(uiDarwinControl(parent));
 }
+
+// AppKit already waits until control returns to the run loop before it lays anything out or redraws it, so there's nothing to batch here
+void uiControlBeginUpdate(uiControl *c)
+{
+	// do nothing
+}
+
+void uiControlEndUpdate(uiControl *c)
+{
+	// do nothing
+}
@@ -24,6 +24,19 @@ void uiDrawFreePath(uiDrawPath *p)
 	uiprivFree(p);
 }
 
+// single precision is only a way to save memory, so a regular path is a fine substitute
+uiDrawPath *uiDrawNewSinglePrecisionPath(uiDrawFillMode fillMode)
+{
+	return uiDrawNewPath(fillMode);
+}
+
+// this is only a hint; CGMutablePath doesn't let us preallocate
+void uiDrawPathReserve(uiDrawPath *p, size_t n)
+{
+	if (p->ended)
+		uiprivUserBug("You cannot call uiDrawPathReserve() on a uiDrawPath that has already been ended. (path: %p)", p);
+}
+
 void uiDrawPathNewFigure(uiDrawPath *p, double x, double y)
 {
 	if (p->ended)
@@ -447,3 +460,53 @@ void uiDrawRestore(uiDrawContext *c)
 {
 	CGContextRestoreGState(c->c);
 }
+
+// TODO not implemented on macOS yet; the GTK+ versions are in unix/drawoffscreen.c
+
+uiDrawContext *uiDrawNewImageContext(int pixelWidth, int pixelHeight)
+{
+	uiprivImplBug("uiDrawNewImageContext() is not implemented on macOS yet");
+	return NULL;
+}
+
+uiDrawContext *uiDrawNewPDFContext(const char *filename, double width, double height)
+{
+	uiprivImplBug("uiDrawNewPDFContext() is not implemented on macOS yet");
+	return NULL;
+}
+
+uiDrawContext *uiDrawNewSVGContext(const char *filename, double width, double height)
+{
+	uiprivImplBug("uiDrawNewSVGContext() is not implemented on macOS yet");
+	return NULL;
+}
+
+void uiDrawContextNewPage(uiDrawContext *c)
+{
+	uiprivImplBug("uiDrawContextNewPage() is not implemented on macOS yet");
+}
+
+const void *uiDrawContextPixels(uiDrawContext *c, int *byteStride)
+{
+	uiprivImplBug("uiDrawContextPixels() is not implemented on macOS yet");
+	return NULL;
+}
+
+int uiDrawContextWritePNG(uiDrawContext *c, const char *filename)
+{
+	uiprivImplBug("uiDrawContextWritePNG() is not implemented on macOS yet");
+	return 0;
+}
+
+void uiDrawFreeContext(uiDrawContext *c)
+{
+	uiprivImplBug("uiDrawFreeContext() is not implemented on macOS yet");
+}
+
+// TODO not implemented on macOS yet; the GTK+ version is in unix/drawpath.c
+
+uiDrawPath *uiDrawNewFramePath(uiDrawContext *c, uiDrawFillMode fillMode)
+{
+	uiprivImplBug("uiDrawNewFramePath() is not implemented on macOS yet");
+	return NULL;
+}
@@ -212,3 +212,75 @@ void uiDrawTextLayoutExtents(uiDrawTextLayout *tl, double *width, double *height
 	[tl->frame returnWidth:width height:NULL];
 	[tl->forLines returnWidth:NULL height:height];
 }
+
+// TODO not implemented on macOS yet; the GTK+ versions are in unix/drawtext.c and unix/drawglyphs.c
+
+int uiDrawTextLayoutNumLines(uiDrawTextLayout *tl)
+{
+	uiprivImplBug("uiDrawTextLayoutNumLines() is not implemented on macOS yet");
+	return 0;
+}
+
+void uiDrawTextLayoutLineByteRange(uiDrawTextLayout *tl, int line, size_t *start, size_t *end)
+{
+	uiprivImplBug("uiDrawTextLayoutLineByteRange() is not implemented on macOS yet");
+}
+
+void uiDrawTextLayoutLineGetMetrics(uiDrawTextLayout *tl, int line, uiDrawTextLayoutLineMetrics *m)
+{
+	uiprivImplBug("uiDrawTextLayoutLineGetMetrics() is not implemented on macOS yet");
+}
+
+int uiDrawTextLayoutLineForByte(uiDrawTextLayout *tl, size_t pos)
+{
+	uiprivImplBug("uiDrawTextLayoutLineForByte() is not implemented on macOS yet");
+	return 0;
+}
+
+double uiDrawTextLayoutByteLocationInLine(uiDrawTextLayout *tl, size_t pos, int line)
+{
+	uiprivImplBug("uiDrawTextLayoutByteLocationInLine() is not implemented on macOS yet");
+	return 0;
+}
+
+void uiDrawTextLayoutHitTest(uiDrawTextLayout *tl, double x, double y, size_t *pos, int *line)
+{
+	uiprivImplBug("uiDrawTextLayoutHitTest() is not implemented on macOS yet");
+}
+
+void uiDrawTextLayoutForEachRangeRect(uiDrawTextLayout *tl, size_t start, size_t end, uiDrawTextLayoutRangeRectFunc f, void *data)
+{
+	uiprivImplBug("uiDrawTextLayoutForEachRangeRect() is not implemented on macOS yet");
+}
+
+uiDrawTextLayoutTask *uiDrawNewTextLayoutAsync(uiDrawTextLayoutParams *params, uiDrawTextLayoutTaskFunc f, void *data)
+{
+	uiprivImplBug("uiDrawNewTextLayoutAsync() is not implemented on macOS yet");
+	return NULL;
+}
+
+void uiDrawTextLayoutTaskCancel(uiDrawTextLayoutTask *task)
+{
+	uiprivImplBug("uiDrawTextLayoutTaskCancel() is not implemented on macOS yet");
+}
+
+uiDrawGlyphFont *uiDrawNewGlyphFont(const uiFontDescriptor *desc)
+{
+	uiprivImplBug("uiDrawNewGlyphFont() is not implemented on macOS yet");
+	return NULL;
+}
+
+void uiDrawFreeGlyphFont(uiDrawGlyphFont *f)
+{
+	uiprivImplBug("uiDrawFreeGlyphFont() is not implemented on macOS yet");
+}
+
+void uiDrawGlyphFontExtents(uiDrawGlyphFont *f, const char *text, double *width, double *height)
+{
+	uiprivImplBug("uiDrawGlyphFontExtents() is not implemented on macOS yet");
+}
+
+void uiDrawGlyphRuns(uiDrawContext *c, uiDrawGlyphFont *f, const uiDrawGlyphRun *runs, size_t n, uiDrawBrush *b)
+{
+	uiprivImplBug("uiDrawGlyphRuns() is not implemented on macOS yet");
+}
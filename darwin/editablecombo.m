@@ -184,3 +184,15 @@ uiEditableCombobox *uiNewEditableCombobox(void)
 
 	return c;
 }
+
+// TODO not implemented on macOS yet; the GTK+ version is in unix/editablecombo.c
+
+void uiEditableComboboxSetItems(uiEditableCombobox *c, const char *const *items, int n)
+{
+	uiprivImplBug("uiEditableComboboxSetItems() is not implemented on macOS yet");
+}
+
+void uiEditableComboboxSetVirtualItems(uiEditableCombobox *c, int n, const char *(*item)(uiEditableCombobox *c, int i, void *data), void *data)
+{
+	uiprivImplBug("uiEditableComboboxSetVirtualItems() is not implemented on macOS yet");
+}
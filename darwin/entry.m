@@ -59,6 +59,7 @@ struct uiEntry {
 	NSTextField *textfield;
 	void (*onChanged)(uiEntry *, void *);
 	void *onChangedData;
+	uiprivThrottle *throttle;
 };
 
 static BOOL isSearchField(NSTextField *tf)
@@ -101,7 +102,7 @@ static BOOL isSearchField(NSTextField *tf)
 	uiEntry *e;
 
 	e = (uiEntry *) uiprivMapGet(self->entries, sender);
-	(*(e->onChanged))(e, e->onChangedData);
+	uiprivThrottleNotify(e->throttle);
 }
 
 - (void)registerEntry:(uiEntry *)e
@@ -134,6 +135,7 @@ static void uiEntryDestroy(uiControl *c)
 	uiEntry *e = uiEntry(c);
 
 	[entryDelegate unregisterEntry:e];
+	uiprivFreeThrottle(e->throttle);
 	[e->textfield release];
 	uiFreeControl(uiControl(e));
 }
@@ -155,6 +157,11 @@ void uiEntryOnChanged(uiEntry *e, void (*f)(uiEntry *, void *), void *data)
 	e->onChangedData = data;
 }
 
+void uiEntrySetChangePolicy(uiEntry *e, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(e->throttle, policy, milliseconds);
+}
+
 int uiEntryReadOnly(uiEntry *e)
 {
 	return [e->textfield isEditable] == NO;
@@ -175,6 +182,13 @@ static void defaultOnChanged(uiEntry *e, void *data)
 	// do nothing
 }
 
+static void fireChanged(void *data)
+{
+	uiEntry *e = uiEntry(data);
+
+	(*(e->onChanged))(e, e->onChangedData);
+}
+
 // these are based on interface builder defaults; my comments in the old code weren't very good so I don't really know what talked about what, sorry :/
 void uiprivFinishNewTextField(NSTextField *t, BOOL isEntry)
 {
@@ -213,6 +227,7 @@ static uiEntry *finishNewEntry(Class class)
 	uiDarwinNewControl(uiEntry, e);
 
 	e->textfield = realNewEditableTextField(class);
+	e->throttle = uiprivNewThrottle(fireChanged, e);
 
 	if (entryDelegate == nil) {
 		entryDelegate = [[entryDelegateClass new] autorelease];
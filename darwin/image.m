@@ -84,3 +84,53 @@ NSImage *uiprivImageNSImage(uiImage *i)
 {
 	return i->i;
 }
+
+// uiImageAppend() copies the pixels into an NSBitmapImageRep anyway, so any stride works as well as any other
+int uiImagePreferredByteStride(int pixelWidth)
+{
+	return pixelWidth * 4;
+}
+
+// TODO not implemented on macOS yet; the GTK+ versions are in unix/image.c and unix/pixelbuffer.c
+
+void uiImageAppendPremultiplied(uiImage *i, void *pixels, int pixelWidth, int pixelHeight, int byteStride)
+{
+	uiprivImplBug("uiImageAppendPremultiplied() is not implemented on macOS yet");
+}
+
+void uiImageAppendBorrowed(uiImage *i, void *pixels, int pixelWidth, int pixelHeight, int byteStride, void (*destroy)(void *pixels, void *data), void *data)
+{
+	uiprivImplBug("uiImageAppendBorrowed() is not implemented on macOS yet");
+}
+
+void uiDrawImage(uiDrawContext *c, uiImage *img, double x, double y, double width, double height, uiDrawImageFilter filter)
+{
+	uiprivImplBug("uiDrawImage() is not implemented on macOS yet");
+}
+
+uiPixelBuffer *uiNewPixelBuffer(int pixelWidth, int pixelHeight)
+{
+	uiprivImplBug("uiNewPixelBuffer() is not implemented on macOS yet");
+	return NULL;
+}
+
+void uiFreePixelBuffer(uiPixelBuffer *pb)
+{
+	uiprivImplBug("uiFreePixelBuffer() is not implemented on macOS yet");
+}
+
+void *uiPixelBufferMap(uiPixelBuffer *pb, int *byteStride)
+{
+	uiprivImplBug("uiPixelBufferMap() is not implemented on macOS yet");
+	return NULL;
+}
+
+void uiPixelBufferUnmap(uiPixelBuffer *pb, int x, int y, int width, int height)
+{
+	uiprivImplBug("uiPixelBufferUnmap() is not implemented on macOS yet");
+}
+
+void uiDrawPixelBuffer(uiDrawContext *c, uiPixelBuffer *pb, double x, double y, double width, double height, uiDrawImageFilter filter)
+{
+	uiprivImplBug("uiDrawPixelBuffer() is not implemented on macOS yet");
+}
@@ -286,3 +286,29 @@ void uiTimer(int milliseconds, int (*f)(void *data), void *data)
 
 // TODO figure out the best way to clean the above up in uiUninit(), if it's even necessary
 // TODO that means figure out if timers can still fire without the main loop
+
+// documented in ui.h: there is no file descriptor to give out here
+int uiMainGetPollFD(void)
+{
+	return -1;
+}
+
+// TODO not implemented on macOS yet; the GTK+ versions are in unix/main.c
+
+const char *uiInitHeadless(uiInitOptions *options)
+{
+	uiprivImplBug("uiInitHeadless() is not implemented on macOS yet");
+	return NULL;
+}
+
+int uiMainPrepare(void)
+{
+	uiprivImplBug("uiMainPrepare() is not implemented on macOS yet");
+	return 0;
+}
+
+int uiMainDispatch(int budgetMilliseconds)
+{
+	uiprivImplBug("uiMainDispatch() is not implemented on macOS yet");
+	return 0;
+}
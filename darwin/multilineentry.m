@@ -18,6 +18,7 @@ struct uiMultilineEntry {
 	void (*onChanged)(uiMultilineEntry *, void *);
 	void *onChangedData;
 	BOOL changing;
+	uiprivThrottle *throttle;
 };
 
 @implementation intrinsicSizeTextView
@@ -48,7 +49,7 @@ struct uiMultilineEntry {
 	[super didChangeText];
 	[self invalidateIntrinsicContentSize];
 	if (!self->libui_e->changing)
-		(*(self->libui_e->onChanged))(self->libui_e, self->libui_e->onChangedData);
+		uiprivThrottleNotify(self->libui_e->throttle);
 }
 
 @end
@@ -60,6 +61,7 @@ static void uiMultilineEntryDestroy(uiControl *c)
 	uiMultilineEntry *e = uiMultilineEntry(c);
 
 	uiprivScrollViewFreeData(e->sv, e->d);
+	uiprivFreeThrottle(e->throttle);
 	[e->tv release];
 	[e->sv release];
 	uiFreeControl(uiControl(e));
@@ -70,6 +72,13 @@ static void defaultOnChanged(uiMultilineEntry *e, void *data)
 	// do nothing
 }
 
+static void fireChanged(void *data)
+{
+	uiMultilineEntry *e = uiMultilineEntry(data);
+
+	(*(e->onChanged))(e, e->onChangedData);
+}
+
 char *uiMultilineEntryText(uiMultilineEntry *e)
 {
 	return uiDarwinNSStringToText([e->tv string]);
@@ -101,6 +110,11 @@ void uiMultilineEntryOnChanged(uiMultilineEntry *e, void (*f)(uiMultilineEntry *
 	e->onChangedData = data;
 }
 
+void uiMultilineEntrySetChangePolicy(uiMultilineEntry *e, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(e->throttle, policy, milliseconds);
+}
+
 int uiMultilineEntryReadOnly(uiMultilineEntry *e)
 {
 	return [e->tv isEditable] == NO;
@@ -124,6 +138,7 @@ static uiMultilineEntry *finishMultilineEntry(BOOL hscroll)
 
 	uiDarwinNewControl(uiMultilineEntry, e);
 
+	e->throttle = uiprivNewThrottle(fireChanged, e);
 	e->tv = [[intrinsicSizeTextView alloc] initWithFrame:NSZeroRect e:e];
 
 	// verified against Interface Builder for a sufficiently customized text view
@@ -231,3 +246,28 @@ uiMultilineEntry *uiNewNonWrappingMultilineEntry(void)
 {
 	return finishMultilineEntry(YES);
 }
+
+// TODO not implemented on macOS yet; the GTK+ versions are in unix/multilineentry.c
+
+int uiMultilineEntryNumLines(uiMultilineEntry *e)
+{
+	uiprivImplBug("uiMultilineEntryNumLines() is not implemented on macOS yet");
+	return 0;
+}
+
+char *uiMultilineEntryTextRange(uiMultilineEntry *e, int firstLine, int nLines)
+{
+	uiprivImplBug("uiMultilineEntryTextRange() is not implemented on macOS yet");
+	return NULL;
+}
+
+int uiMultilineEntryMaxLines(uiMultilineEntry *e)
+{
+	uiprivImplBug("uiMultilineEntryMaxLines() is not implemented on macOS yet");
+	return 0;
+}
+
+void uiMultilineEntrySetMaxLines(uiMultilineEntry *e, int maxLines)
+{
+	uiprivImplBug("uiMultilineEntrySetMaxLines() is not implemented on macOS yet");
+}
@@ -0,0 +1,7 @@
+// 19 october 2026
+#import "uipriv_darwin.h"
+
+void uiprivParallelFor(size_t n, uiprivParallelFunc f, void *data)
+{
+	dispatch_apply_f(n, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), data, f);
+}
@@ -205,3 +205,10 @@ uiRadioButtons *uiNewRadioButtons(void)
 
 	return r;
 }
+
+// TODO not implemented on macOS yet; the GTK+ version is in unix/radiobuttons.c
+
+void uiRadioButtonsSetItems(uiRadioButtons *r, const char *const *items, int n)
+{
+	uiprivImplBug("uiRadioButtonsSetItems() is not implemented on macOS yet");
+}
@@ -26,6 +26,7 @@ struct uiSlider {
 	NSSlider *slider;
 	void (*onChanged)(uiSlider *, void *);
 	void *onChangedData;
+	uiprivThrottle *throttle;
 };
 
 @interface sliderDelegateClass : NSObject {
@@ -57,7 +58,7 @@ struct uiSlider {
 	uiSlider *s;
 
 	s = (uiSlider *) uiprivMapGet(self->sliders, sender);
-	(*(s->onChanged))(s, s->onChangedData);
+	uiprivThrottleNotify(s->throttle);
 }
 
 - (void)registerSlider:(uiSlider *)s
@@ -84,6 +85,7 @@ static void uiSliderDestroy(uiControl *c)
 	uiSlider *s = uiSlider(c);
 
 	[sliderDelegate unregisterSlider:s];
+	uiprivFreeThrottle(s->throttle);
 	[s->slider release];
 	uiFreeControl(uiControl(s));
 }
@@ -104,11 +106,23 @@ void uiSliderOnChanged(uiSlider *s, void (*f)(uiSlider *, void *), void *data)
 	s->onChangedData = data;
 }
 
+void uiSliderSetChangePolicy(uiSlider *s, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(s->throttle, policy, milliseconds);
+}
+
 static void defaultOnChanged(uiSlider *s, void *data)
 {
 	// do nothing
 }
 
+static void fireChanged(void *data)
+{
+	uiSlider *s = uiSlider(data);
+
+	(*(s->onChanged))(s, s->onChangedData);
+}
+
 uiSlider *uiNewSlider(int min, int max)
 {
 	uiSlider *s;
@@ -136,6 +150,7 @@ uiSlider *uiNewSlider(int min, int max)
 	cell = (NSSliderCell *) [s->slider cell];
 	[cell setSliderType:NSLinearSlider];
 
+	s->throttle = uiprivNewThrottle(fireChanged, s);
 	if (sliderDelegate == nil) {
 		sliderDelegate = [[sliderDelegateClass new] autorelease];
 		[uiprivDelegates addObject:sliderDelegate];
@@ -27,6 +27,7 @@ struct uiSpinbox {
 	libui_spinbox *spinbox;
 	void (*onChanged)(uiSpinbox *, void *);
 	void *onChangedData;
+	uiprivThrottle *throttle;
 };
 
 // yes folks, this varies by operating system! woo!
@@ -156,18 +157,27 @@ static CGFloat stepperYDelta(void)
 - (IBAction)stepperClicked:(id)sender
 {
 	[self libui_setValue:[self->stepper integerValue]];
-	(*(self->spinbox->onChanged))(self->spinbox, self->spinbox->onChangedData);
+	uiprivThrottleNotify(self->spinbox->throttle);
 }
 
 - (void)controlTextDidChange:(NSNotification *)note
 {
 	[self libui_setValue:[self->tf integerValue]];
-	(*(self->spinbox->onChanged))(self->spinbox, self->spinbox->onChangedData);
+	uiprivThrottleNotify(self->spinbox->throttle);
 }
 
 @end
 
-uiDarwinControlAllDefaults(uiSpinbox, spinbox)
+uiDarwinControlAllDefaultsExceptDestroy(uiSpinbox, spinbox)
+
+static void uiSpinboxDestroy(uiControl *c)
+{
+	uiSpinbox *s = uiSpinbox(c);
+
+	uiprivFreeThrottle(s->throttle);
+	[s->spinbox release];
+	uiFreeControl(uiControl(s));
+}
 
 int uiSpinboxValue(uiSpinbox *s)
 {
@@ -185,11 +195,23 @@ void uiSpinboxOnChanged(uiSpinbox *s, void (*f)(uiSpinbox *, void *), void *data
 	s->onChangedData = data;
 }
 
+void uiSpinboxSetChangePolicy(uiSpinbox *s, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(s->throttle, policy, milliseconds);
+}
+
 static void defaultOnChanged(uiSpinbox *s, void *data)
 {
 	// do nothing
 }
 
+static void fireChanged(void *data)
+{
+	uiSpinbox *s = uiSpinbox(data);
+
+	(*(s->onChanged))(s, s->onChangedData);
+}
+
 uiSpinbox *uiNewSpinbox(int min, int max)
 {
 	uiSpinbox *s;
@@ -203,6 +225,8 @@ uiSpinbox *uiNewSpinbox(int min, int max)
 
 	uiDarwinNewControl(uiSpinbox, s);
 
+	s->throttle = uiprivNewThrottle(fireChanged, s);
+
 	s->spinbox = [[libui_spinbox alloc] initWithFrame:NSZeroRect spinbox:s];
 	[s->spinbox setMinimum:min];
 	[s->spinbox setMaximum:max];
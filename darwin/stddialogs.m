@@ -121,3 +121,30 @@ void uiMsgBoxError(uiWindow *parent, const char *title, const char *description)
 {
 	msgbox(windowWindow(parent), title, description, NSCriticalAlertStyle);
 }
+
+// TODO not implemented on macOS yet; the GTK+ versions are in unix/stddialogs.c
+
+void uiOpenFileAsync(uiWindow *parent, void (*f)(uiWindow *parent, const char *filename, void *data), void *data)
+{
+	uiprivImplBug("uiOpenFileAsync() is not implemented on macOS yet");
+}
+
+void uiOpenFilesAsync(uiWindow *parent, void (*f)(uiWindow *parent, const char *const *filenames, int n, void *data), void *data)
+{
+	uiprivImplBug("uiOpenFilesAsync() is not implemented on macOS yet");
+}
+
+void uiSaveFileAsync(uiWindow *parent, void (*f)(uiWindow *parent, const char *filename, void *data), void *data)
+{
+	uiprivImplBug("uiSaveFileAsync() is not implemented on macOS yet");
+}
+
+void uiMsgBoxAsync(uiWindow *parent, const char *title, const char *description, void (*f)(uiWindow *parent, void *data), void *data)
+{
+	uiprivImplBug("uiMsgBoxAsync() is not implemented on macOS yet");
+}
+
+void uiMsgBoxErrorAsync(uiWindow *parent, const char *title, const char *description, void (*f)(uiWindow *parent, void *data), void *data)
+{
+	uiprivImplBug("uiMsgBoxErrorAsync() is not implemented on macOS yet");
+}
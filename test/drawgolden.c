@@ -0,0 +1,262 @@
+// 19 october 2026
+#include "test.h"
+#include <time.h>
+#include <sys/stat.h>
+#include <cairo.h>
+
+// This runs every draw test in drawtests.c into an offscreen image, compares the result to a reference PNG, and times it.
+// Results are printed to stdout as JSON; diagnostics go to stderr. The exit status is nonzero if any test failed.
+// Run with -update to (re)write the reference PNGs from the current output instead of comparing.
+// A test also fails if anything libui allocated while drawing it is still allocated once its context is freed.
+
+#ifndef GOLDEN_DIR
+#define GOLDEN_DIR "golden"
+#endif
+
+// allocations are counted with libui's own statistics (see uiGetMemoryStats()), so this only sees what libui allocates itself, not what cairo or pango do
+static void memoryCounts(uint64_t *total, size_t *live)
+{
+	uiMemoryStats *ms;
+
+	ms = uiGetMemoryStats();
+	*total = ms->TotalAllocs;
+	*live = ms->LiveCount;
+	uiFreeMemoryStats(ms);
+}
+
+static struct {
+	int update;
+	int iterations;
+	int tolerance;		// largest per-channel difference that still counts as the same
+	double maxBadFraction;		// fraction of pixels allowed to exceed tolerance
+	const char *dir;
+	int width;
+	int height;
+} opts = {
+	0,
+	100,
+	2,
+	0.001,
+	GOLDEN_DIR,
+	640,
+	480,
+};
+
+static uint64_t nsnow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// turns "cairo samples: arc negative" into "cairo-samples-arc-negative"
+static void fileName(char *buf, size_t n, const char *name)
+{
+	char *p;
+	int dash;
+
+	p = buf + snprintf(buf, n, "%s/", opts.dir);
+	dash = 0;
+	for (; *name != '\0' && p < buf + n - 5; name++) {
+		if ((*name >= 'a' && *name <= 'z') || (*name >= '0' && *name <= '9')) {
+			*p++ = *name;
+			dash = 0;
+		} else if (*name >= 'A' && *name <= 'Z') {
+			*p++ = *name - 'A' + 'a';
+			dash = 0;
+		} else if (!dash) {
+			*p++ = '-';
+			dash = 1;
+		}
+	}
+	if (dash)
+		p--;
+	strcpy(p, ".png");
+}
+
+static void jsonString(const char *s)
+{
+	putchar('"');
+	for (; *s != '\0'; s++)
+		switch (*s) {
+		case '"':
+		case '\\':
+			putchar('\\');
+			// fall through
+		default:
+			putchar(*s);
+		}
+	putchar('"');
+}
+
+static void draw(uiDrawContext *c, int n)
+{
+	uiAreaDrawParams p;
+
+	p.Context = c;
+	p.AreaWidth = opts.width;
+	p.AreaHeight = opts.height;
+	p.ClipX = 0;
+	p.ClipY = 0;
+	p.ClipWidth = opts.width;
+	p.ClipHeight = opts.height;
+	uiDrawSave(c);
+	runDrawTest(n, &p);
+	uiDrawRestore(c);
+}
+
+struct result {
+	const char *status;
+	int maxDiff;
+	long long badPixels;
+};
+
+static void compare(uiDrawContext *c, const char *filename, struct result *r)
+{
+	cairo_surface_t *ref;
+	const uint8_t *got, *want;
+	int gotStride, wantStride;
+	int x, y, d;
+
+	ref = cairo_image_surface_create_from_png(filename);
+	if (cairo_surface_status(ref) != CAIRO_STATUS_SUCCESS) {
+		r->status = "missing";
+		cairo_surface_destroy(ref);
+		return;
+	}
+	if (cairo_image_surface_get_format(ref) != CAIRO_FORMAT_ARGB32 ||
+		cairo_image_surface_get_width(ref) != opts.width ||
+		cairo_image_surface_get_height(ref) != opts.height) {
+		r->status = "size-mismatch";
+		cairo_surface_destroy(ref);
+		return;
+	}
+	got = (const uint8_t *) uiDrawContextPixels(c, &gotStride);
+	want = cairo_image_surface_get_data(ref);
+	wantStride = cairo_image_surface_get_stride(ref);
+	for (y = 0; y < opts.height; y++) {
+		for (x = 0; x < opts.width * 4; x += 4) {
+			int worst = 0;
+			int i;
+
+			for (i = 0; i < 4; i++) {
+				d = abs(got[x + i] - want[x + i]);
+				if (worst < d)
+					worst = d;
+			}
+			if (r->maxDiff < worst)
+				r->maxDiff = worst;
+			if (worst > opts.tolerance)
+				r->badPixels++;
+		}
+		got += gotStride;
+		want += wantStride;
+	}
+	cairo_surface_destroy(ref);
+	r->status = "pass";
+	if (r->badPixels > opts.maxBadFraction * opts.width * opts.height)
+		r->status = "fail";
+}
+
+static void usage(const char *argv0)
+{
+	fprintf(stderr, "usage: %s [-update] [-n iterations] [-tolerance channel-diff] [-maxbad fraction] [-dir reference-dir] [-size width height]\n", argv0);
+	exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+	uiInitOptions o;
+	const char *err;
+	uiDrawContext *c;
+	struct result r;
+	char filename[1024];
+	uint64_t start, ns;
+	uint64_t allocsBefore, allocsAfter;
+	size_t liveBefore, liveAfter;
+	int i, j, n;
+	int failed;
+
+	for (i = 1; i < argc; i++)
+		if (strcmp(argv[i], "-update") == 0)
+			opts.update = 1;
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			opts.iterations = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-tolerance") == 0 && i + 1 < argc)
+			opts.tolerance = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-maxbad") == 0 && i + 1 < argc)
+			opts.maxBadFraction = atof(argv[++i]);
+		else if (strcmp(argv[i], "-dir") == 0 && i + 1 < argc)
+			opts.dir = argv[++i];
+		else if (strcmp(argv[i], "-size") == 0 && i + 2 < argc) {
+			opts.width = atoi(argv[++i]);
+			opts.height = atoi(argv[++i]);
+		} else
+			usage(argv[0]);
+	if (opts.iterations < 1 || opts.width < 1 || opts.height < 1)
+		usage(argv[0]);
+
+	memset(&o, 0, sizeof (uiInitOptions));
+	err = uiInitHeadless(&o);
+	if (err != NULL) {
+		fprintf(stderr, "error initializing ui: %s\n", err);
+		uiFreeInitError(err);
+		return 1;
+	}
+
+	if (opts.update)
+		// if this fails, writing the first PNG will say so
+		mkdir(opts.dir, 0777);
+
+	failed = 0;
+	n = numDrawTests();
+	printf("{\n\t\"width\": %d,\n\t\"height\": %d,\n\t\"iterations\": %d,\n\t\"tests\": [\n",
+		opts.width, opts.height, opts.iterations);
+	for (i = 0; i < n; i++) {
+		fileName(filename, sizeof (filename), drawTestName(i));
+		memset(&r, 0, sizeof (struct result));
+
+		c = uiDrawNewImageContext(opts.width, opts.height);
+		draw(c, i);
+		if (opts.update) {
+			r.status = "updated";
+			if (!uiDrawContextWritePNG(c, filename)) {
+				fprintf(stderr, "error writing %s\n", filename);
+				r.status = "write-error";
+			}
+		} else
+			compare(c, filename, &r);
+
+		// the first draw above warmed up any caches; now time the steady state
+		// drawing over the previous result is fine; we only care about the time here
+		// with the caches warm, drawing the same thing again shouldn't leave anything more allocated
+		memoryCounts(&allocsBefore, &liveBefore);
+		start = nsnow();
+		for (j = 0; j < opts.iterations; j++)
+			draw(c, i);
+		ns = nsnow() - start;
+		memoryCounts(&allocsAfter, &liveAfter);
+		uiDrawFreeContext(c);
+		if (liveAfter > liveBefore)
+			if (strcmp(r.status, "pass") == 0 || strcmp(r.status, "updated") == 0)
+				r.status = "leak";
+
+		if (strcmp(r.status, "pass") != 0 && strcmp(r.status, "updated") != 0) {
+			fprintf(stderr, "%s: %s (%s)\n", drawTestName(i), r.status, filename);
+			failed++;
+		}
+
+		printf("\t\t{ \"name\": ");
+		jsonString(drawTestName(i));
+		printf(", \"status\": \"%s\", \"maxDiff\": %d, \"badPixels\": %lld, \"nsPerOp\": %.0f, \"allocsPerOp\": %.2f }%s\n",
+			r.status, r.maxDiff, r.badPixels,
+			((double) ns) / opts.iterations,
+			((double) (allocsAfter - allocsBefore)) / opts.iterations,
+			i == n - 1 ? "" : ",");
+	}
+	printf("\t],\n\t\"failed\": %d\n}\n", failed);
+
+	uiUninit();
+	return failed != 0;
+}
@@ -1970,6 +1970,20 @@ void runDrawTest(int n, uiAreaDrawParams *p)
 	(*(tests[n].draw))(p);
 }
 
+int numDrawTests(void)
+{
+	int n;
+
+	for (n = 0; tests[n].name != NULL; n++)
+		;
+	return n;
+}
+
+const char *drawTestName(int n)
+{
+	return tests[n].name;
+}
+
 void populateComboboxWithTests(uiCombobox *c)
 {
 	size_t i;
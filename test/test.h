@@ -52,6 +52,8 @@ extern uiBox *makePage6(void);
 
 // drawtests.c
 extern void runDrawTest(int, uiAreaDrawParams *);
+extern int numDrawTests(void);
+extern const char *drawTestName(int);
 extern void populateComboboxWithTests(uiCombobox *);
 
 // page7.c
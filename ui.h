@@ -52,12 +52,52 @@ struct uiInitOptions {
 };
 
 _UI_EXTERN const char *uiInit(uiInitOptions *options);
+// uiInitHeadless() is like uiInit(), except that it does not connect to
+// a display. After uiInitHeadless(), you may only use functions that
+// do not create controls or windows or run the main loop: drawing into
+// contexts made with uiDrawNewImageContext() and friends, text layout,
+// attributed strings, and images. This is meant for rendering in batch
+// on machines that have no display, such as servers and CI runners.
+// Call uiUninit() when you are done as usual.
+_UI_EXTERN const char *uiInitHeadless(uiInitOptions *options);
 _UI_EXTERN void uiUninit(void);
 _UI_EXTERN void uiFreeInitError(const char *err);
 
 _UI_EXTERN void uiMain(void);
 _UI_EXTERN void uiMainSteps(void);
 _UI_EXTERN int uiMainStep(int wait);
+
+// uiMainGetPollFD(), uiMainPrepare(), and uiMainDispatch() let you
+// run libui's event loop from inside another event loop, such as one
+// built on epoll or libuv, without a second thread and without
+// polling. Call uiMainSteps() first, then get the file descriptor
+// from uiMainGetPollFD() and add it to your loop. Then, each time
+// around your loop:
+//
+// 1. Call uiMainPrepare(). It returns the longest time, in
+//    milliseconds, your loop may wait before calling uiMainDispatch(),
+//    or -1 if it may wait indefinitely.
+// 2. Wait until the file descriptor is readable or that time passes,
+//    along with whatever else your loop waits for.
+// 3. Call uiMainDispatch(). It handles whatever libui events are
+//    ready, and then keeps handling events that become ready until
+//    budgetMilliseconds have passed, so that libui does not starve the
+//    rest of your loop. A budget of 0 handles only the events that
+//    were ready when it was called. It returns 0 once uiQuit() has
+//    been called, the same way uiMainStep() does.
+//
+// uiMainPrepare() and uiMainDispatch() must always be called in pairs.
+// The file descriptor stays the same for the life of the program.
+// Only read its readiness; never read from or close it.
+//
+// The file descriptor is only available on Linux, where it is an epoll
+// file descriptor. Everywhere else, uiMainGetPollFD() returns -1; on
+// the other Unix systems, call uiMainPrepare() and uiMainDispatch()
+// regularly instead. uiMainPrepare() and uiMainDispatch() are not
+// implemented on Windows or macOS yet.
+_UI_EXTERN int uiMainGetPollFD(void);
+_UI_EXTERN int uiMainPrepare(void);
+_UI_EXTERN int uiMainDispatch(int budgetMilliseconds);
 _UI_EXTERN void uiQuit(void);
 
 _UI_EXTERN void uiQueueMain(void (*f)(void *data), void *data);
@@ -74,6 +114,56 @@ _UI_EXTERN void uiOnShouldQuit(int (*f)(void *data), void *data);
 
 _UI_EXTERN void uiFreeText(char *text);
 
+// uiMemoryTypeStats describes the memory libui has allocated for
+// one kind of internal object. Type is the name libui uses for that
+// kind of object in leak reports, such as "uiDrawPath" or
+// "char[] (uiAttributedString)"; it is not meant to be parsed.
+typedef struct uiMemoryTypeStats uiMemoryTypeStats;
+
+struct uiMemoryTypeStats {
+	const char *Type;
+	// LiveBytes and LiveCount are the number of bytes and blocks
+	// currently allocated.
+	size_t LiveBytes;
+	size_t LiveCount;
+	// PeakBytes is the largest LiveBytes has ever been.
+	size_t PeakBytes;
+	// TotalAllocs is the number of blocks ever allocated, including
+	// ones that have since been freed. Resizing a block does not
+	// count as a new allocation.
+	uint64_t TotalAllocs;
+};
+
+// uiMemoryStats is a snapshot of the memory libui has allocated for
+// its own objects, both in total and broken down by type. It does not
+// include memory allocated by the OS or by the toolkit libui is built
+// on.
+typedef struct uiMemoryStats uiMemoryStats;
+
+struct uiMemoryStats {
+	// these are the same as in uiMemoryTypeStats, but for all types
+	// together
+	size_t LiveBytes;
+	size_t LiveCount;
+	size_t PeakBytes;
+	uint64_t TotalAllocs;
+	// Types has NumTypes elements, sorted by LiveBytes, largest
+	// first.
+	size_t NumTypes;
+	uiMemoryTypeStats *Types;
+};
+
+// @role uiMemoryStats constructor
+// uiGetMemoryStats() returns a snapshot of libui's memory use. The
+// snapshot does not change afterward; call uiGetMemoryStats() again
+// to get a new one. This is cheap enough to call periodically, for
+// instance from a uiTimer() that updates a dashboard.
+_UI_EXTERN uiMemoryStats *uiGetMemoryStats(void);
+
+// @role uiMemoryStats destructor
+// uiFreeMemoryStats() frees s.
+_UI_EXTERN void uiFreeMemoryStats(uiMemoryStats *s);
+
 typedef struct uiControl uiControl;
 
 struct uiControl {
@@ -106,6 +196,16 @@ _UI_EXTERN int uiControlEnabled(uiControl *);
 _UI_EXTERN void uiControlEnable(uiControl *);
 _UI_EXTERN void uiControlDisable(uiControl *);
 
+// uiControlBeginUpdate() and uiControlEndUpdate() bracket a batch of
+// changes to c and its children, such as rebuilding a uiBox or uiGrid
+// with hundreds of controls. Between the two calls, c is not redrawn
+// and containers put off the work of re-laying out their children;
+// uiControlEndUpdate() then lays c out and redraws it once. The calls
+// may be nested; only the outermost uiControlEndUpdate() does
+// anything.
+_UI_EXTERN void uiControlBeginUpdate(uiControl *c);
+_UI_EXTERN void uiControlEndUpdate(uiControl *c);
+
 _UI_EXTERN uiControl *uiAllocControl(size_t n, uint32_t OSsig, uint32_t typesig, const char *typenamestr);
 _UI_EXTERN void uiFreeControl(uiControl *);
 
@@ -148,6 +248,39 @@ _UI_EXTERN void uiBoxSetPadded(uiBox *b, int padded);
 _UI_EXTERN uiBox *uiNewHorizontalBox(void);
 _UI_EXTERN uiBox *uiNewVerticalBox(void);
 
+// uiVirtualBox is a vertically scrolling list of items, like a
+// uiBox of uiBoxes, for when there are too many items to make a
+// control for each. Instead, it makes only enough item controls to
+// fill what is visible, and reuses them as the user scrolls, so its
+// cost depends on its size on screen rather than on the number of
+// items.
+//
+// It gets its item controls from a uiVirtualBoxHandler. NewItem()
+// makes a new item control; it can be any control, and is usually a
+// horizontal uiBox. BindItem() fills in the contents of an item
+// control for item index; it is called each time an item control is
+// reused for a different item, so it should update everything about
+// item that differs between items. Item controls belong to the
+// uiVirtualBox and are destroyed with it.
+//
+// All items are the same height: itemHeight, in points, or, if
+// itemHeight is 0, the height the first item control asks for.
+typedef struct uiVirtualBox uiVirtualBox;
+typedef struct uiVirtualBoxHandler uiVirtualBoxHandler;
+#define uiVirtualBox(this) ((uiVirtualBox *) (this))
+struct uiVirtualBoxHandler {
+	uiControl *(*NewItem)(uiVirtualBoxHandler *, uiVirtualBox *);
+	void (*BindItem)(uiVirtualBoxHandler *, uiVirtualBox *, uiControl *item, int index);
+};
+_UI_EXTERN int uiVirtualBoxNumItems(uiVirtualBox *vb);
+// uiVirtualBoxSetNumItems() also rebinds every visible item, so call it
+// whenever the items change wholesale.
+_UI_EXTERN void uiVirtualBoxSetNumItems(uiVirtualBox *vb, int n);
+// uiVirtualBoxItemChanged() rebinds item index if it is visible.
+_UI_EXTERN void uiVirtualBoxItemChanged(uiVirtualBox *vb, int index);
+_UI_EXTERN void uiVirtualBoxScrollTo(uiVirtualBox *vb, int index);
+_UI_EXTERN uiVirtualBox *uiNewVirtualBox(uiVirtualBoxHandler *h, int itemHeight);
+
 typedef struct uiCheckbox uiCheckbox;
 #define uiCheckbox(this) ((uiCheckbox *) (this))
 _UI_EXTERN char *uiCheckboxText(uiCheckbox *c);
@@ -157,11 +290,36 @@ _UI_EXTERN int uiCheckboxChecked(uiCheckbox *c);
 _UI_EXTERN void uiCheckboxSetChecked(uiCheckbox *c, int checked);
 _UI_EXTERN uiCheckbox *uiNewCheckbox(const char *text);
 
+// uiChangePolicy says when a control that can change many times a
+// second, such as a uiSlider being dragged, calls its OnChanged
+// handler.
+//
+// - uiChangePolicyImmediate, the default, calls the handler on every
+//   change.
+// - uiChangePolicyPerFrame calls the handler at most once for all the
+//   changes that happen while libui handles one batch of events, that
+//   is, about once per screen refresh.
+// - uiChangePolicyDebounce calls the handler once changes stop coming
+//   in for at least the given number of milliseconds.
+// - uiChangePolicyThrottle calls the handler on the first change, then
+//   at most once every given number of milliseconds for as long as
+//   changes keep coming in, and once more for the last change.
+//
+// Whatever the policy, the handler is always eventually called after
+// the last change, and the control's value is always up to date.
+_UI_ENUM(uiChangePolicy) {
+	uiChangePolicyImmediate,
+	uiChangePolicyPerFrame,
+	uiChangePolicyDebounce,
+	uiChangePolicyThrottle,
+};
+
 typedef struct uiEntry uiEntry;
 #define uiEntry(this) ((uiEntry *) (this))
 _UI_EXTERN char *uiEntryText(uiEntry *e);
 _UI_EXTERN void uiEntrySetText(uiEntry *e, const char *text);
 _UI_EXTERN void uiEntryOnChanged(uiEntry *e, void (*f)(uiEntry *e, void *data), void *data);
+_UI_EXTERN void uiEntrySetChangePolicy(uiEntry *e, uiChangePolicy policy, int milliseconds);
 _UI_EXTERN int uiEntryReadOnly(uiEntry *e);
 _UI_EXTERN void uiEntrySetReadOnly(uiEntry *e, int readonly);
 _UI_EXTERN uiEntry *uiNewEntry(void);
@@ -203,6 +361,7 @@ typedef struct uiSpinbox uiSpinbox;
 _UI_EXTERN int uiSpinboxValue(uiSpinbox *s);
 _UI_EXTERN void uiSpinboxSetValue(uiSpinbox *s, int value);
 _UI_EXTERN void uiSpinboxOnChanged(uiSpinbox *s, void (*f)(uiSpinbox *s, void *data), void *data);
+_UI_EXTERN void uiSpinboxSetChangePolicy(uiSpinbox *s, uiChangePolicy policy, int milliseconds);
 _UI_EXTERN uiSpinbox *uiNewSpinbox(int min, int max);
 
 typedef struct uiSlider uiSlider;
@@ -210,6 +369,7 @@ typedef struct uiSlider uiSlider;
 _UI_EXTERN int uiSliderValue(uiSlider *s);
 _UI_EXTERN void uiSliderSetValue(uiSlider *s, int value);
 _UI_EXTERN void uiSliderOnChanged(uiSlider *s, void (*f)(uiSlider *s, void *data), void *data);
+_UI_EXTERN void uiSliderSetChangePolicy(uiSlider *s, uiChangePolicy policy, int milliseconds);
 _UI_EXTERN uiSlider *uiNewSlider(int min, int max);
 
 typedef struct uiProgressBar uiProgressBar;
@@ -226,6 +386,20 @@ _UI_EXTERN uiSeparator *uiNewVerticalSeparator(void);
 typedef struct uiCombobox uiCombobox;
 #define uiCombobox(this) ((uiCombobox *) (this))
 _UI_EXTERN void uiComboboxAppend(uiCombobox *c, const char *text);
+// uiComboboxSetItems() replaces all of c's items with the n strings
+// in items at once, which is much faster than calling
+// uiComboboxAppend() n times. The selection is cleared.
+_UI_EXTERN void uiComboboxSetItems(uiCombobox *c, const char *const *items, int n);
+// uiComboboxSetVirtualItems() replaces all of c's items with n items
+// that c does not store; instead, c calls item to get the text of
+// item i when it needs it. The returned string only needs to stay
+// valid until the next call to item. Where the OS can't show a
+// popup that only asks for visible items, c asks for every item
+// once and keeps a copy of its text. Call this again to change the
+// number of items or to make c ask for their text again. The
+// selection is cleared. You cannot call uiComboboxAppend() on c until
+// you call uiComboboxSetItems().
+_UI_EXTERN void uiComboboxSetVirtualItems(uiCombobox *c, int n, const char *(*item)(uiCombobox *c, int i, void *data), void *data);
 _UI_EXTERN int uiComboboxSelected(uiCombobox *c);
 _UI_EXTERN void uiComboboxSetSelected(uiCombobox *c, int n);
 _UI_EXTERN void uiComboboxOnSelected(uiCombobox *c, void (*f)(uiCombobox *c, void *data), void *data);
@@ -234,6 +408,11 @@ _UI_EXTERN uiCombobox *uiNewCombobox(void);
 typedef struct uiEditableCombobox uiEditableCombobox;
 #define uiEditableCombobox(this) ((uiEditableCombobox *) (this))
 _UI_EXTERN void uiEditableComboboxAppend(uiEditableCombobox *c, const char *text);
+// uiEditableComboboxSetItems() and uiEditableComboboxSetVirtualItems()
+// work like uiComboboxSetItems() and uiComboboxSetVirtualItems(). The
+// text in the entry is left alone.
+_UI_EXTERN void uiEditableComboboxSetItems(uiEditableCombobox *c, const char *const *items, int n);
+_UI_EXTERN void uiEditableComboboxSetVirtualItems(uiEditableCombobox *c, int n, const char *(*item)(uiEditableCombobox *c, int i, void *data), void *data);
 _UI_EXTERN char *uiEditableComboboxText(uiEditableCombobox *c);
 _UI_EXTERN void uiEditableComboboxSetText(uiEditableCombobox *c, const char *text);
 // TODO what do we call a function that sets the currently selected item and fills the text field with it? editable comboboxes have no consistent concept of selected item
@@ -243,6 +422,9 @@ _UI_EXTERN uiEditableCombobox *uiNewEditableCombobox(void);
 typedef struct uiRadioButtons uiRadioButtons;
 #define uiRadioButtons(this) ((uiRadioButtons *) (this))
 _UI_EXTERN void uiRadioButtonsAppend(uiRadioButtons *r, const char *text);
+// uiRadioButtonsSetItems() replaces all of r's buttons with one for
+// each of the n strings in items, re-laying out r only once.
+_UI_EXTERN void uiRadioButtonsSetItems(uiRadioButtons *r, const char *const *items, int n);
 _UI_EXTERN int uiRadioButtonsSelected(uiRadioButtons *r);
 _UI_EXTERN void uiRadioButtonsSetSelected(uiRadioButtons *r, int n);
 _UI_EXTERN void uiRadioButtonsOnSelected(uiRadioButtons *r, void (*f)(uiRadioButtons *, void *), void *data);
@@ -264,8 +446,28 @@ typedef struct uiMultilineEntry uiMultilineEntry;
 #define uiMultilineEntry(this) ((uiMultilineEntry *) (this))
 _UI_EXTERN char *uiMultilineEntryText(uiMultilineEntry *e);
 _UI_EXTERN void uiMultilineEntrySetText(uiMultilineEntry *e, const char *text);
+// uiMultilineEntryAppend() adds text to the end of e. Appends may be
+// collected and shown together on the next screen refresh, so that
+// a log pane that is appended to many times a second stays fast; the
+// other uiMultilineEntry functions always see all the text appended
+// so far. If e was scrolled all the way to the bottom, it stays
+// scrolled to the bottom.
 _UI_EXTERN void uiMultilineEntryAppend(uiMultilineEntry *e, const char *text);
+// uiMultilineEntryNumLines() returns the number of lines in e. Text
+// that ends in a newline has an empty last line.
+_UI_EXTERN int uiMultilineEntryNumLines(uiMultilineEntry *e);
+// uiMultilineEntryTextRange() returns nLines lines of e's text,
+// starting at line firstLine, without copying the rest of the text.
+// Free the returned string with uiFreeText().
+_UI_EXTERN char *uiMultilineEntryTextRange(uiMultilineEntry *e, int firstLine, int nLines);
+// uiMultilineEntrySetMaxLines() limits e to maxLines lines; whenever
+// more are added, the oldest lines are dropped. A trailing newline
+// does not count as starting a new line. 0, the default, means no
+// limit.
+_UI_EXTERN int uiMultilineEntryMaxLines(uiMultilineEntry *e);
+_UI_EXTERN void uiMultilineEntrySetMaxLines(uiMultilineEntry *e, int maxLines);
 _UI_EXTERN void uiMultilineEntryOnChanged(uiMultilineEntry *e, void (*f)(uiMultilineEntry *e, void *data), void *data);
+_UI_EXTERN void uiMultilineEntrySetChangePolicy(uiMultilineEntry *e, uiChangePolicy policy, int milliseconds);
 _UI_EXTERN int uiMultilineEntryReadOnly(uiMultilineEntry *e);
 _UI_EXTERN void uiMultilineEntrySetReadOnly(uiMultilineEntry *e, int readonly);
 _UI_EXTERN uiMultilineEntry *uiNewMultilineEntry(void);
@@ -294,6 +496,22 @@ _UI_EXTERN char *uiSaveFile(uiWindow *parent);
 _UI_EXTERN void uiMsgBox(uiWindow *parent, const char *title, const char *description);
 _UI_EXTERN void uiMsgBoxError(uiWindow *parent, const char *title, const char *description);
 
+// The Async versions of the above show the same dialogs, but return
+// right away instead of waiting for the user to close them; other
+// events keep being handled as usual in the meantime. When the user
+// closes the dialog, f is called. The filenames passed to f are NULL
+// (or, for uiOpenFilesAsync(), n is 0) if the user cancelled, and
+// are only valid until f returns; copy them if you need them later.
+// f may be NULL for uiMsgBoxAsync() and uiMsgBoxErrorAsync().
+// If parent is destroyed while the dialog is still open, the dialog
+// is closed along with it and f is not called.
+_UI_EXTERN void uiOpenFileAsync(uiWindow *parent, void (*f)(uiWindow *parent, const char *filename, void *data), void *data);
+// uiOpenFilesAsync() lets the user choose more than one file.
+_UI_EXTERN void uiOpenFilesAsync(uiWindow *parent, void (*f)(uiWindow *parent, const char *const *filenames, int n, void *data), void *data);
+_UI_EXTERN void uiSaveFileAsync(uiWindow *parent, void (*f)(uiWindow *parent, const char *filename, void *data), void *data);
+_UI_EXTERN void uiMsgBoxAsync(uiWindow *parent, const char *title, const char *description, void (*f)(uiWindow *parent, void *data), void *data);
+_UI_EXTERN void uiMsgBoxErrorAsync(uiWindow *parent, const char *title, const char *description, void (*f)(uiWindow *parent, void *data), void *data);
+
 typedef struct uiArea uiArea;
 typedef struct uiAreaHandler uiAreaHandler;
 typedef struct uiAreaDrawParams uiAreaDrawParams;
@@ -456,6 +674,49 @@ struct uiDrawStrokeParams {
 _UI_EXTERN uiDrawPath *uiDrawNewPath(uiDrawFillMode fillMode);
 _UI_EXTERN void uiDrawFreePath(uiDrawPath *p);
 
+// uiDrawNewFramePath() is like uiDrawNewPath(), except that the path
+// belongs to c and is freed automatically when the uiAreaHandler's
+// Draw() that c was given to returns (or, for offscreen contexts, when
+// c is freed). Frame paths are carved out of memory the uiArea keeps
+// from one Draw() to the next, so creating lots of short-lived paths
+// this way does not allocate anything once the uiArea has drawn a
+// few frames. Calling uiDrawFreePath() on a frame path does nothing,
+// so code that calls it anyway continues to work. It is a programmer
+// error to use a frame path after Draw() returns.
+_UI_EXTERN uiDrawPath *uiDrawNewFramePath(uiDrawContext *c, uiDrawFillMode fillMode);
+
+// uiDrawNewSinglePrecisionPath() is like uiDrawNewPath(), except that
+// the path stores its coordinates in single precision, taking half
+// the memory. This is meant for paths with lots of points, such as
+// plots of large data sets; coordinates keep only about 7 significant
+// digits, which is plenty for anything that ends up on screen.
+_UI_EXTERN uiDrawPath *uiDrawNewSinglePrecisionPath(uiDrawFillMode fillMode);
+
+// uiDrawPathReserve() makes room in p for n more line segments, so
+// that building a path of known size doesn't need to reallocate as it
+// goes. Other kinds of segments take more room, so this is a hint
+// rather than a guarantee for them.
+_UI_EXTERN void uiDrawPathReserve(uiDrawPath *p, size_t n);
+
+// uiDrawDecimatePolyline() reduces the polyline through the n points
+// (xs[i], ys[i]) to the points that are visible once m is applied to
+// them, and stores the indices of those points in indices, in order.
+// m should map the points to device pixels; pass NULL if they already
+// are in device pixels. indices must have room for n elements. The
+// number of indices stored is returned.
+//
+// The polyline through the points that are kept draws the same
+// pixels as the polyline through all of them whenever the x
+// coordinates are sorted (for instance, a time series), and at most
+// four points are kept per device pixel column. Other polylines are
+// still drawn correctly, but are reduced by less. Large inputs are
+// processed on multiple threads.
+_UI_EXTERN size_t uiDrawDecimatePolyline(const double *xs, const double *ys, size_t n, const uiDrawMatrix *m, size_t *indices);
+
+// uiDrawPathAddPolyline() begins a new figure in p and adds to it the
+// polyline through the points that uiDrawDecimatePolyline() keeps.
+_UI_EXTERN void uiDrawPathAddPolyline(uiDrawPath *p, const double *xs, const double *ys, size_t n, const uiDrawMatrix *m);
+
 _UI_EXTERN void uiDrawPathNewFigure(uiDrawPath *p, double x, double y);
 _UI_EXTERN void uiDrawPathNewFigureWithArc(uiDrawPath *p, double xCenter, double yCenter, double radius, double startAngle, double sweep, int negative);
 _UI_EXTERN void uiDrawPathLineTo(uiDrawPath *p, double x, double y);
@@ -499,6 +760,50 @@ _UI_EXTERN void uiDrawClip(uiDrawContext *c, uiDrawPath *path);
 _UI_EXTERN void uiDrawSave(uiDrawContext *c);
 _UI_EXTERN void uiDrawRestore(uiDrawContext *c);
 
+// uiDrawNewImageContext() creates a uiDrawContext that draws into
+// an offscreen image pixelWidth by pixelHeight pixels in size,
+// starting out transparent. One unit in the context is one pixel.
+// Unlike the uiDrawContext given to a uiAreaHandler, an offscreen
+// context can be used at any time (on the main thread), including
+// after uiInitHeadless(), and must be freed with uiDrawFreeContext().
+_UI_EXTERN uiDrawContext *uiDrawNewImageContext(int pixelWidth, int pixelHeight);
+
+// uiDrawNewPDFContext() creates a uiDrawContext that draws into a
+// PDF file with pages width by height points in size. One unit in the
+// context is one point (1/72 inch). The file is finished when the
+// context is freed. Returns NULL if the file could not be created.
+_UI_EXTERN uiDrawContext *uiDrawNewPDFContext(const char *filename, double width, double height);
+
+// uiDrawNewSVGContext() is like uiDrawNewPDFContext(), but makes
+// an SVG file. SVG files only have one page.
+_UI_EXTERN uiDrawContext *uiDrawNewSVGContext(const char *filename, double width, double height);
+
+// uiDrawContextNewPage() ends the current page of a context made
+// with uiDrawNewPDFContext() and starts a new, blank one. It is a
+// programmer error to call this on any other context.
+_UI_EXTERN void uiDrawContextNewPage(uiDrawContext *c);
+
+// uiDrawContextWritePNG() writes the contents of a context made with
+// uiDrawNewImageContext() to the given file as a PNG. It returns
+// nonzero on success and zero on failure. It is a programmer error
+// to call this on any other context.
+_UI_EXTERN int uiDrawContextWritePNG(uiDrawContext *c, const char *filename);
+
+// uiDrawContextPixels() returns the pixels of a context made with
+// uiDrawNewImageContext(), in the format described at
+// uiImageAppendPremultiplied(), and stores the number of bytes per
+// row in byteStride. The pixels belong to c and reflect everything
+// drawn so far; they stay valid until the next drawing call on c or
+// until c is freed. It is a programmer error to call this on any other
+// context.
+_UI_EXTERN const void *uiDrawContextPixels(uiDrawContext *c, int *byteStride);
+
+// @role uiDrawContext destructor
+// uiDrawFreeContext() frees a context made with one of the
+// functions above. It is a programmer error to free the context given
+// to a uiAreaHandler.
+_UI_EXTERN void uiDrawFreeContext(uiDrawContext *c);
+
 // uiAttribute stores information about an attribute in a
 // uiAttributedString.
 //
@@ -880,14 +1185,37 @@ _UI_EXTERN void uiAttributedStringInsertAtUnattributed(uiAttributedString *s, co
 // s in the byte range [start, end).
 _UI_EXTERN void uiAttributedStringDelete(uiAttributedString *s, size_t start, size_t end);
 
-// TODO add a function to uiAttributedString to get an attribute's value at a specific index or in a specific range, so we can edit
-
 // uiAttributedStringSetAttribute() sets a in the byte range [start, end)
 // of s. Any existing attributes in that byte range of the same type are
 // removed. s takes ownership of a; you should not use it after
 // uiAttributedStringSetAttribute() returns.
 _UI_EXTERN void uiAttributedStringSetAttribute(uiAttributedString *s, uiAttribute *a, size_t start, size_t end);
 
+// uiAttributeRun is a uiAttribute and the byte range [Start, End) of a
+// uiAttributedString it applies to. See
+// uiAttributedStringSetAttributesBulk().
+typedef struct uiAttributeRun uiAttributeRun;
+
+struct uiAttributeRun {
+	uiAttribute *Attribute;
+	size_t Start;
+	size_t End;
+};
+
+// uiAttributedStringSetAttributesBulk() does the same thing as
+// calling uiAttributedStringSetAttribute() on each of the n runs in
+// order, but in a single pass over s, taking time linear in the number
+// of runs and attributes instead of quadratic. This is meant for things
+// like syntax highlighters that restyle a lot of text at once. The runs
+// must be sorted by Start, and runs whose uiAttributes have the same
+// type must not overlap.
+//
+// s takes ownership of the Attribute of every run. The same uiAttribute
+// may be used in more than one run. Equal uiAttributes are merged, so
+// runs that each have their own copy of the same color still only keep
+// one copy around.
+_UI_EXTERN void uiAttributedStringSetAttributesBulk(uiAttributedString *s, const uiAttributeRun *runs, size_t n);
+
 // uiAttributedStringForEachAttribute() enumerates all the
 // uiAttributes in s. It is an error to modify s in f. Within f, s still
 // owns the attribute; you can neither free it nor save it for later
@@ -896,6 +1224,37 @@ _UI_EXTERN void uiAttributedStringSetAttribute(uiAttributedString *s, uiAttribut
 // TODO define an enumeration order (or mark it as undefined); also define how consecutive runs of identical attributes are handled here and sync with the definition of uiAttributedString itself
 _UI_EXTERN void uiAttributedStringForEachAttribute(const uiAttributedString *s, uiAttributedStringForEachAttributeFunc f, void *data);
 
+// uiAttributedStringForEachAttributeInRange() is like
+// uiAttributedStringForEachAttribute(), but only enumerates the
+// uiAttributes that cover at least one byte of the byte range
+// [start, end) of s, in order of their start positions. The start and end
+// given to f are those of the whole attribute, not just the part inside
+// [start, end). Finding the first attribute takes time logarithmic in the
+// number of attributes in s, not linear.
+_UI_EXTERN void uiAttributedStringForEachAttributeInRange(const uiAttributedString *s, size_t start, size_t end, uiAttributedStringForEachAttributeFunc f, void *data);
+
+// uiAttributedStringAttributesAt() enumerates the uiAttributes that
+// apply to the byte at pos in s, such as to show the formatting at a
+// text cursor. There is at most one attribute of each type.
+_UI_EXTERN void uiAttributedStringAttributesAt(const uiAttributedString *s, size_t pos, uiAttributedStringForEachAttributeFunc f, void *data);
+
+// uiAttributedStringGeneration() returns a number that increases
+// every time the text or the attributes of s change. Save it along with
+// anything you compute from s, then pass it to
+// uiAttributedStringChangedSince() to find out what to recompute.
+_UI_EXTERN uint64_t uiAttributedStringGeneration(const uiAttributedString *s);
+
+// uiAttributedStringChangedSince() returns nonzero if s has changed
+// since uiAttributedStringGeneration() returned generation, and zero
+// otherwise. If it returns nonzero, [*start, *end) is a byte range of
+// s as it is now that covers every insertion and every change of
+// attributes since then. A deletion shows up as an empty range at the
+// point where the text was removed, so the range can be empty if that
+// was the only change. Only a limited number of recent changes are
+// kept; if there have been more than that, the whole string is
+// returned.
+_UI_EXTERN int uiAttributedStringChangedSince(const uiAttributedString *s, uint64_t generation, size_t *start, size_t *end);
+
 // TODO const correct this somehow (the implementation needs to mutate the structure)
 _UI_EXTERN size_t uiAttributedStringNumGraphemes(uiAttributedString *s);
 
@@ -986,7 +1345,207 @@ _UI_EXTERN void uiDrawText(uiDrawContext *c, uiDrawTextLayout *tl, double x, dou
 // function to get the actual size of the text layout.
 _UI_EXTERN void uiDrawTextLayoutExtents(uiDrawTextLayout *tl, double *width, double *height);
 
-// TODO metrics functions
+// uiDrawTextLayoutTask represents a uiDrawTextLayout that is
+// being created in the background by uiDrawNewTextLayoutAsync().
+typedef struct uiDrawTextLayoutTask uiDrawTextLayoutTask;
+
+// uiDrawTextLayoutTaskFunc is the type of the function called when
+// a uiDrawTextLayoutTask finishes. tl is the finished layout, which
+// you own and must free with uiDrawFreeTextLayout(). task is no
+// longer valid after this function returns.
+typedef void (*uiDrawTextLayoutTaskFunc)(uiDrawTextLayoutTask *task, uiDrawTextLayout *tl, void *data);
+
+// uiDrawNewTextLayoutAsync() is like uiDrawNewTextLayout(), except
+// that the expensive parts of creating the layout (shaping and
+// wrapping the text) happen on a background thread. When the
+// layout is ready, f is called on the main thread, the same way
+// uiQueueMain() functions are.
+//
+// A copy of params, including the text and attributes of its
+// uiAttributedString, is taken before uiDrawNewTextLayoutAsync()
+// returns, so you are free to change or free the string afterward.
+// If you do change it, you will probably want to cancel the task
+// with uiDrawTextLayoutTaskCancel() and start a new one.
+_UI_EXTERN uiDrawTextLayoutTask *uiDrawNewTextLayoutAsync(uiDrawTextLayoutParams *params, uiDrawTextLayoutTaskFunc f, void *data);
+
+// uiDrawTextLayoutTaskCancel() cancels task. The function passed to
+// uiDrawNewTextLayoutAsync() will not be called, and task is no
+// longer valid after uiDrawTextLayoutTaskCancel() returns. You
+// cannot cancel a task whose function has already been called.
+_UI_EXTERN void uiDrawTextLayoutTaskCancel(uiDrawTextLayoutTask *task);
+
+// uiDrawTextLayoutLineMetrics describes a single line of a
+// uiDrawTextLayout. All values are in the coordinate system of
+// the layout, with (0, 0) being the top-left point passed to
+// uiDrawText(). X, Y, Width, and Height describe the bounding
+// box of the line; the baseline of the line starts at (X, BaselineY).
+// Ascent + Descent gives the typographic height of the line.
+typedef struct uiDrawTextLayoutLineMetrics uiDrawTextLayoutLineMetrics;
+
+struct uiDrawTextLayoutLineMetrics {
+	double X;
+	double Y;
+	double Width;
+	double Height;
+	double BaselineY;
+	double Ascent;
+	double Descent;
+};
+
+// uiDrawTextLayoutNumLines() returns the number of lines in tl.
+// This number will always be greater than or equal to 1; a text
+// layout with no text only has one line.
+//
+// The first call to this or any of the following line functions
+// builds an index of the lines in tl; after that, looking up a line
+// by position or by byte offset takes logarithmic time, so these
+// functions are suitable for implementing carets and selections
+// on very large layouts.
+_UI_EXTERN int uiDrawTextLayoutNumLines(uiDrawTextLayout *tl);
+
+// uiDrawTextLayoutLineByteRange() returns the byte indices of the
+// text that falls into the given line of tl as [start, end).
+_UI_EXTERN void uiDrawTextLayoutLineByteRange(uiDrawTextLayout *tl, int line, size_t *start, size_t *end);
+
+// uiDrawTextLayoutLineGetMetrics() returns the metrics of the
+// given line of tl in m.
+_UI_EXTERN void uiDrawTextLayoutLineGetMetrics(uiDrawTextLayout *tl, int line, uiDrawTextLayoutLineMetrics *m);
+
+// uiDrawTextLayoutLineForByte() returns the line of tl that
+// contains the byte at pos. A pos at the end of the text returns
+// the last line.
+_UI_EXTERN int uiDrawTextLayoutLineForByte(uiDrawTextLayout *tl, size_t pos);
+
+// uiDrawTextLayoutHitTest() returns the byte offset and line closest
+// to the given point, which is relative to the top-left of the layout.
+// If the point is outside the layout itself, the closest point is
+// chosen; this allows the function to be used for cursor positioning
+// with the mouse. pos is always on a grapheme boundary; if the
+// point falls in the trailing half of a grapheme, pos is the
+// position after it.
+_UI_EXTERN void uiDrawTextLayoutHitTest(uiDrawTextLayout *tl, double x, double y, size_t *pos, int *line);
+
+// uiDrawTextLayoutByteLocationInLine() returns the x coordinate,
+// relative to the layout, at which a caret at byte pos would be
+// drawn on the given line. pos must be in the range [start, end]
+// of the line, as returned by uiDrawTextLayoutLineByteRange(); if it
+// is not, a negative value is returned, indicating you need to
+// move the cursor to another line.
+_UI_EXTERN double uiDrawTextLayoutByteLocationInLine(uiDrawTextLayout *tl, size_t pos, int line);
+
+// uiDrawTextLayoutRangeRectFunc is the type of the function
+// called by uiDrawTextLayoutForEachRangeRect() for each
+// rectangle covered by a byte range. The rectangle is relative to
+// the top-left of the layout.
+typedef uiForEach (*uiDrawTextLayoutRangeRectFunc)(uiDrawTextLayout *tl, double x, double y, double width, double height, void *data);
+
+// uiDrawTextLayoutForEachRangeRect() calls f for each rectangle
+// covered by the bytes [start, end) of tl, in line order. A range
+// that spans several lines, or that contains text in both
+// directions, produces several rectangles. This is what you
+// would use to draw a text selection.
+_UI_EXTERN void uiDrawTextLayoutForEachRangeRect(uiDrawTextLayout *tl, size_t start, size_t end, uiDrawTextLayoutRangeRectFunc f, void *data);
+
+// uiDrawTextDocument lays out a very large uiAttributedString
+// for display in a uiArea. Instead of a single uiDrawTextLayout for
+// the whole string, the string is split into paragraphs at each
+// newline, and each paragraph is laid out only when it is first
+// drawn. Paragraphs that have not been laid out yet are given an
+// estimated height based on their length, and the estimate is
+// replaced by the real height as paragraphs are laid out; finding
+// the paragraph at a given y position takes logarithmic time, so
+// scrolling stays fast no matter how long the document is.
+//
+// Because heights are estimated, uiDrawTextDocumentHeight() may
+// change as the document is drawn.
+//
+// The uiAttributedString and uiFontDescriptor in the
+// uiDrawTextLayoutParams are used by reference and must outlive
+// the uiDrawTextDocument. When you change the uiAttributedString,
+// you must call uiDrawTextDocumentRangeChanged() so the affected
+// paragraphs can be laid out again.
+typedef struct uiDrawTextDocument uiDrawTextDocument;
+
+// @role uiDrawTextDocument constructor
+// uiDrawNewTextDocument() creates a new uiDrawTextDocument
+// from the given parameters.
+_UI_EXTERN uiDrawTextDocument *uiDrawNewTextDocument(uiDrawTextLayoutParams *params);
+
+// @role uiDrawTextDocument destructor
+// uiDrawFreeTextDocument() frees d. The underlying
+// uiAttributedString is not freed.
+_UI_EXTERN void uiDrawFreeTextDocument(uiDrawTextDocument *d);
+
+// uiDrawTextDocumentDraw() draws the parts of d that intersect
+// the clip rectangle in p, with the top-left point of d at (x, y).
+// Only the paragraphs that are visible are laid out.
+//
+// Which paragraphs are visible is worked out from the clip
+// rectangle in p alone, which is in the coordinates that
+// p->Context had when your draw handler was called. If you have
+// changed the transform of p->Context with uiDrawTransform(),
+// make a copy of p whose clip rectangle is the bounding box of
+// the original clip rectangle mapped through the inverse of your
+// transform, and pass that instead; otherwise paragraphs that
+// should be visible may not be drawn.
+_UI_EXTERN void uiDrawTextDocumentDraw(uiAreaDrawParams *p, uiDrawTextDocument *d, double x, double y);
+
+// uiDrawTextDocumentHeight() returns the current height of d,
+// which includes estimated heights for paragraphs that have not
+// been laid out yet.
+_UI_EXTERN double uiDrawTextDocumentHeight(uiDrawTextDocument *d);
+
+// uiDrawTextDocumentSetWidth() changes the width that d is
+// wrapped to. All paragraphs will be laid out again as needed.
+_UI_EXTERN void uiDrawTextDocumentSetWidth(uiDrawTextDocument *d, double width);
+
+// uiDrawTextDocumentRangeChanged() tells d that the bytes
+// [start, oldEnd) of its uiAttributedString have been replaced
+// by the bytes [start, newEnd). To report a change to attributes
+// only, pass the same value for oldEnd and newEnd. Only the
+// paragraphs that contain the changed range are laid out again.
+_UI_EXTERN void uiDrawTextDocumentRangeChanged(uiDrawTextDocument *d, size_t start, size_t oldEnd, size_t newEnd);
+
+// uiDrawGlyphFont is a font prepared for drawing large numbers
+// of short, unattributed strings (such as chart axis labels or
+// spreadsheet cells) quickly. Each distinct codepoint is looked up
+// in the font only once, the first time it is drawn or measured;
+// after that, a string is drawn by reusing the cached glyphs and
+// advances, and any number of strings can be drawn in one call.
+//
+// Because each codepoint is handled on its own, strings drawn
+// with a uiDrawGlyphFont are not kerned and do not get ligatures
+// or complex script shaping. Use a uiDrawTextLayout for text that
+// needs those.
+typedef struct uiDrawGlyphFont uiDrawGlyphFont;
+
+// @role uiDrawGlyphFont constructor
+// uiDrawNewGlyphFont() creates a new uiDrawGlyphFont for the
+// font described by desc. desc is not retained.
+_UI_EXTERN uiDrawGlyphFont *uiDrawNewGlyphFont(const uiFontDescriptor *desc);
+
+// @role uiDrawGlyphFont destructor
+// uiDrawFreeGlyphFont() frees f.
+_UI_EXTERN void uiDrawFreeGlyphFont(uiDrawGlyphFont *f);
+
+// uiDrawGlyphRun describes a single string to draw with
+// uiDrawGlyphRuns(). Text is a NUL-terminated UTF-8 string. As
+// with uiDrawText(), (X, Y) is the top-left point of the string.
+typedef struct uiDrawGlyphRun uiDrawGlyphRun;
+
+struct uiDrawGlyphRun {
+	const char *Text;
+	double X;
+	double Y;
+};
+
+// uiDrawGlyphRuns() draws the n strings in runs in c using f,
+// filling them with b.
+_UI_EXTERN void uiDrawGlyphRuns(uiDrawContext *c, uiDrawGlyphFont *f, const uiDrawGlyphRun *runs, size_t n, uiDrawBrush *b);
+
+// uiDrawGlyphFontExtents() returns the width and height that
+// text would take up if drawn with f in width and height.
+_UI_EXTERN void uiDrawGlyphFontExtents(uiDrawGlyphFont *f, const char *text, double *width, double *height);
 
 // TODO number of lines visible for clipping rect, range visible for clipping rect?
 
@@ -1141,9 +1700,11 @@ _UI_EXTERN uiGrid *uiNewGrid(void);
 // 	  resolution; this matches the current expectations of some
 // 	  desktop systems at the time of writing (mid-2018)
 // 
-// uiImage is very simple: it only supports non-premultiplied 32-bit
-// RGBA images, and libui does not provide any image file loading
-// or image format conversion utilities on top of that.
+// uiImage is very simple: it only supports 32-bit RGBA images,
+// either non-premultiplied or premultiplied in libui's native pixel
+// format (see uiImageAppendPremultiplied()), and libui does not
+// provide any image file loading or image format conversion
+// utilities on top of that.
 typedef struct uiImage uiImage;
 
 // @role uiImage constructor
@@ -1164,9 +1725,106 @@ _UI_EXTERN void uiFreeImage(uiImage *i);
 // pixelHeight is the size *in pixels* of the image, and pixelStride is
 // the number *of bytes* per row of the pixels array. Therefore,
 // pixels itself must be at least byteStride * pixelHeight bytes long.
-// TODO see if we either need the stride or can provide a way to get the OS-preferred stride (in cairo we do)
+// The pixels are converted to the OS's native format and copied,
+// so you can free pixels once uiImageAppend returns.
 _UI_EXTERN void uiImageAppend(uiImage *i, void *pixels, int pixelWidth, int pixelHeight, int byteStride);
 
+// uiImagePreferredByteStride() returns the byteStride that the
+// OS prefers for a representation pixelWidth pixels wide. Passing
+// this stride to uiImageAppendPremultiplied() and
+// uiImageAppendBorrowed() lets them skip work.
+_UI_EXTERN int uiImagePreferredByteStride(int pixelWidth);
+
+// uiImageAppendPremultiplied is like uiImageAppend, except that
+// pixels are already premultiplied and in the format libui uses
+// internally: each pixel is a native-endian uint32_t of the form
+// 0xAARRGGBB (so on little-endian systems, the bytes are in
+// [B G R A] order). No conversion is done; the pixels are copied
+// in a single block if byteStride is uiImagePreferredByteStride(),
+// and row by row otherwise.
+_UI_EXTERN void uiImageAppendPremultiplied(uiImage *i, void *pixels, int pixelWidth, int pixelHeight, int byteStride);
+
+// uiImageAppendBorrowed is like uiImageAppendPremultiplied,
+// except that if byteStride is uiImagePreferredByteStride() (and
+// pixels is aligned to a uint32_t), the pixels are used in place
+// instead of being copied. pixels must then stay valid and unchanged
+// until libui calls destroy with pixels and data, which it does once
+// the representation is no longer used; this can be after uiFreeImage
+// returns. If the pixels had to be copied, destroy is called before
+// uiImageAppendBorrowed returns. destroy may be NULL.
+_UI_EXTERN void uiImageAppendBorrowed(uiImage *i, void *pixels, int pixelWidth, int pixelHeight, int byteStride, void (*destroy)(void *pixels, void *data), void *data);
+
+// uiDrawImageFilter specifies how uiDrawImage() samples an image
+// that is drawn at a size other than that of its representations.
+_UI_ENUM(uiDrawImageFilter) {
+	// Nearest uses the closest pixel, without any smoothing.
+	// This is the fastest, and is appropriate for pixel art and for
+	// zooming in to show individual pixels.
+	uiDrawImageFilterNearest,
+	// Linear smooths the image. When the image is drawn much
+	// smaller than its representations, a prescaled copy of the
+	// image is used so that the result doesn't alias.
+	uiDrawImageFilterLinear,
+};
+
+// uiDrawImage() draws img in c, scaled to fill the rectangle with
+// its top-left corner at (x, y) and the given width and height.
+// The representation of img that is drawn depends on how many
+// device pixels that rectangle covers, taking both the current
+// transform and the pixel density of c into account. Any prescaled
+// copies of the image made for a given size are cached in img, so
+// drawing the same image at the same size over and over does not
+// rescale it each time. Nothing is done if the rectangle is
+// entirely outside the current clip.
+_UI_EXTERN void uiDrawImage(uiDrawContext *c, uiImage *img, double x, double y, double width, double height, uiDrawImageFilter filter);
+
+// uiPixelBuffer is a block of pixels that is meant to be changed
+// often, such as for video frames or a scrolling spectrogram. Unlike
+// a uiImage, which is copied once and never changes, a uiPixelBuffer
+// is written in place and only the parts that changed are sent to
+// the screen when it is next drawn.
+//
+// A uiPixelBuffer is double-buffered: the pixels you write with
+// uiPixelBufferMap() are not the pixels that uiDrawPixelBuffer()
+// draws until uiPixelBufferUnmap() publishes them. This means one
+// thread may fill in the next frame while the main thread draws the
+// current one. uiPixelBufferMap() and uiPixelBufferUnmap() may be
+// called from any one thread at a time; all other uiPixelBuffer
+// functions must be called on the main thread.
+//
+// The pixels are in the same format as uiImageAppendPremultiplied().
+typedef struct uiPixelBuffer uiPixelBuffer;
+
+// @role uiPixelBuffer constructor
+// uiNewPixelBuffer() creates a new uiPixelBuffer with the given
+// size in pixels. All the pixels start out transparent.
+_UI_EXTERN uiPixelBuffer *uiNewPixelBuffer(int pixelWidth, int pixelHeight);
+
+// @role uiPixelBuffer destructor
+// uiFreePixelBuffer() frees pb. It is a programmer error to free pb
+// while it is mapped.
+_UI_EXTERN void uiFreePixelBuffer(uiPixelBuffer *pb);
+
+// uiPixelBufferMap() returns a pointer to the pixels of the next
+// frame of pb and stores the number of bytes per row in byteStride.
+// The pixels start out as a copy of the last frame published with
+// uiPixelBufferUnmap(), so you only need to write the pixels that
+// change. The pointer stays valid until uiPixelBufferUnmap().
+_UI_EXTERN void *uiPixelBufferMap(uiPixelBuffer *pb, int *byteStride);
+
+// uiPixelBufferUnmap() publishes the frame written since the last
+// uiPixelBufferMap(). x, y, width, and height give the rectangle, in
+// pixels, that was changed; only that rectangle will be sent to the
+// screen. Pass the whole buffer if you don't know. uiPixelBufferUnmap()
+// does not redraw anything by itself; queue a redraw of the uiArea
+// that draws pb afterward (with uiQueueMain() if you are not on the
+// main thread).
+_UI_EXTERN void uiPixelBufferUnmap(uiPixelBuffer *pb, int x, int y, int width, int height);
+
+// uiDrawPixelBuffer() draws the last published frame of pb into c
+// the same way uiDrawImage() draws a uiImage.
+_UI_EXTERN void uiDrawPixelBuffer(uiDrawContext *c, uiPixelBuffer *pb, double x, double y, double width, double height, uiDrawImageFilter filter);
+
 // uiTableValue stores a value to be passed along uiTable and
 // uiTableModel.
 //
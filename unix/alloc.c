@@ -2,7 +2,8 @@
 #include <string.h>
 #include "uipriv_unix.h"
 
-static GPtrArray *allocations;
+// a set, so that freeing doesn't have to search every live allocation
+static GHashTable *allocations;
 
 #define UINT8(p) ((uint8_t *) (p))
 #define PVOID(p) ((void *) (p))
@@ -15,10 +16,10 @@ static GPtrArray *allocations;
 
 void uiprivInitAlloc(void)
 {
-	allocations = g_ptr_array_new();
+	allocations = g_hash_table_new(g_direct_hash, g_direct_equal);
 }
 
-static void uninitComplain(gpointer ptr, gpointer data)
+static void uninitComplain(gpointer ptr, gpointer value, gpointer data)
 {
 	char **str = (char **) data;
 	char *str2;
@@ -34,11 +35,12 @@ void uiprivUninitAlloc(void)
 {
 	char *str = NULL;
 
-	if (allocations->len == 0) {
-		g_ptr_array_free(allocations, TRUE);
+	uiprivUninitAllocStats();
+	if (g_hash_table_size(allocations) == 0) {
+		g_hash_table_destroy(allocations);
 		return;
 	}
-	g_ptr_array_foreach(allocations, uninitComplain, &str);
+	g_hash_table_foreach(allocations, uninitComplain, &str);
 	uiprivUserBug("Some data was leaked; either you left a uiControl lying around or there's a bug in libui itself. Leaked data:\n%s", str);
 	g_free(str);
 }
@@ -50,7 +52,8 @@ void *uiprivAlloc(size_t size, const char *type)
 	out = g_malloc0(EXTRA + size);
 	*SIZE(out) = size;
 	*TYPE(out) = type;
-	g_ptr_array_add(allocations, out);
+	g_hash_table_add(allocations, out);
+	uiprivAllocStatsAlloc(type, size);
 	return DATA(out);
 }
 
@@ -62,14 +65,15 @@ void *uiprivRealloc(void *p, size_t new, const char *type)
 	if (p == NULL)
 		return uiprivAlloc(new, type);
 	p = BASE(p);
+	if (g_hash_table_remove(allocations, p) == FALSE)
+		uiprivImplBug("%p not found in allocations array in uiprivRealloc()", p);
 	out = g_realloc(p, EXTRA + new);
 	s = SIZE(out);
+	uiprivAllocStatsRealloc(*TYPE(out), *s, new);
 	if (new > *s)
 		memset(((uint8_t *) DATA(out)) + *s, 0, new - *s);
 	*s = new;
-	if (g_ptr_array_remove(allocations, p) == FALSE)
-		uiprivImplBug("%p not found in allocations array in uiprivRealloc()", p);
-	g_ptr_array_add(allocations, out);
+	g_hash_table_add(allocations, out);
 	return DATA(out);
 }
 
@@ -78,7 +82,8 @@ void uiprivFree(void *p)
 	if (p == NULL)
 		uiprivImplBug("attempt to uiprivFree(NULL)");
 	p = BASE(p);
-	g_free(p);
-	if (g_ptr_array_remove(allocations, p) == FALSE)
+	if (g_hash_table_remove(allocations, p) == FALSE)
 		uiprivImplBug("%p not found in allocations array in uiprivFree()", p);
+	uiprivAllocStatsFree(*TYPE(p), *SIZE(p));
+	g_free(p);
 }
@@ -20,6 +20,9 @@ struct areaWidget {
 	// we need this particular object available during init(), so put it here instead of in uiArea
 	// keep a pointer in uiArea for convenience, though
 	uiprivClickCounter cc;
+	// reused from one Draw() to the next so the frame arena behind uiDrawNewFramePath() is too
+	// this is here instead of in uiArea so it can't outlive the uiArea
+	uiDrawContext *context;
 };
 
 struct areaWidgetClass {
@@ -73,6 +76,13 @@ static void areaWidget_init(areaWidget *aw)
 
 static void areaWidget_dispose(GObject *obj)
 {
+	areaWidget *aw = areaWidget(obj);
+
+	// dispose can run more than once
+	if (aw->context != NULL) {
+		uiprivFreeContext(aw->context);
+		aw->context = NULL;
+	}
 	G_OBJECT_CLASS(areaWidget_parent_class)->dispose(obj);
 }
 
@@ -122,8 +132,11 @@ static gboolean areaWidget_draw(GtkWidget *w, cairo_t *cr)
 	uiAreaDrawParams dp;
 	double clipX0, clipY0, clipX1, clipY1;
 
-	dp.Context = uiprivNewContext(cr,
+	if (aw->context == NULL)
+		aw->context = uiprivNewContext(NULL, NULL);
+	uiprivContextBeginFrame(aw->context, cr,
 		gtk_widget_get_style_context(a->widget));
+	dp.Context = aw->context;
 
 	loadAreaSize(a, &(dp.AreaWidth), &(dp.AreaHeight));
 
@@ -136,7 +149,8 @@ static gboolean areaWidget_draw(GtkWidget *w, cairo_t *cr)
 	// no need to save or restore the graphics state to reset transformations; GTK+ does that for us
 	(*(a->ah->Draw))(a->ah, a, &dp);
 
-	uiprivFreeContext(dp.Context);
+	// this frees every uiDrawNewFramePath() path at once
+	uiprivContextEndFrame(aw->context);
 	return FALSE;
 }
 
@@ -9,66 +9,116 @@ struct foreachParams {
 	PangoAttrList *attrs;
 };
 
-static void addattr(struct foreachParams *p, size_t start, size_t end, PangoAttribute *attr)
+/*
+Converting a uiAttribute produces at most two Pango attributes (a color and its alpha), which only differ from one run to the next in their start and end indices.
+So the conversion is done once per attribute value: the Pango attributes are kept as a template, shared by every uiAttribute that is equal to it (through the templates hash table) and cached on each such uiAttribute itself (through its OS data pointer, so repeated uses of the same uiAttribute, which is what splitting runs produces, don't even hash).
+After that, each run only costs a pango_attribute_copy() per Pango attribute; Pango attribute lists take ownership of what is inserted, so that copy can't be avoided.
+*/
+struct template {
+	guint refcount;
+	guint hash;
+	int n;
+	PangoAttribute *attrs[2];
+};
+
+static GHashTable *templates = NULL;
+
+static guint templateHash(gconstpointer key)
+{
+	return ((const struct template *) key)->hash;
+}
+
+static gboolean templateEqual(gconstpointer ka, gconstpointer kb)
+{
+	const struct template *a = (const struct template *) ka;
+	const struct template *b = (const struct template *) kb;
+	int i;
+
+	if (a->n != b->n)
+		return FALSE;
+	for (i = 0; i < a->n; i++)
+		if (!pango_attribute_equal(a->attrs[i], b->attrs[i]))
+			return FALSE;
+	return TRUE;
+}
+
+static void freeTemplate(struct template *t)
+{
+	int i;
+
+	for (i = 0; i < t->n; i++)
+		pango_attribute_destroy(t->attrs[i]);
+	g_free(t);
+}
+
+static void unrefTemplate(void *data)
+{
+	struct template *t = (struct template *) data;
+
+	t->refcount--;
+	if (t->refcount != 0)
+		return;
+	g_hash_table_remove(templates, t);
+	freeTemplate(t);
+}
+
+static void addattr(struct template *t, PangoAttribute *attr)
 {
 	if (attr == NULL)		// in case of a future attribute
 		return;
-	attr->start_index = start;
-	attr->end_index = end;
-	pango_attr_list_insert(p->attrs, attr);
+	t->attrs[t->n] = attr;
+	t->n++;
 }
 
-static uiForEach processAttribute(const uiAttributedString *s, const uiAttribute *attr, size_t start, size_t end, void *data)
+static void convertAttribute(const uiAttribute *attr, struct template *t)
 {
-	struct foreachParams *p = (struct foreachParams *) data;
 	double r, g, b, a;
 	PangoUnderline underline;
 	uiUnderlineColor colorType;
 	const uiOpenTypeFeatures *features;
-	GString *featurestr;
 
 	switch (uiAttributeGetType(attr)) {
 	case uiAttributeTypeFamily:
-		addattr(p, start, end,
+		addattr(t,
 			pango_attr_family_new(uiAttributeFamily(attr)));
 		break;
 	case uiAttributeTypeSize:
-		addattr(p, start, end,
+		addattr(t,
 			pango_attr_size_new(cairoToPango(uiAttributeSize(attr))));
 		break;
 	case uiAttributeTypeWeight:
 		// TODO reverse the misalignment from drawtext.c if it is corrected 
-		addattr(p, start, end,
+		addattr(t,
 			pango_attr_weight_new(uiprivWeightToPangoWeight(uiAttributeWeight(attr))));
 		break;
 	case uiAttributeTypeItalic:
-		addattr(p, start, end,
+		addattr(t,
 			pango_attr_style_new(uiprivItalicToPangoStyle(uiAttributeItalic(attr))));
 		break;
 	case uiAttributeTypeStretch:
-		addattr(p, start, end,
+		addattr(t,
 			pango_attr_stretch_new(uiprivStretchToPangoStretch(uiAttributeStretch(attr))));
 		break;
 	case uiAttributeTypeColor:
 		uiAttributeColor(attr, &r, &g, &b, &a);
-		addattr(p, start, end,
+		addattr(t,
 			pango_attr_foreground_new(
 				(guint16) (r * 65535.0),
 				(guint16) (g * 65535.0),
 				(guint16) (b * 65535.0)));
-		addattr(p, start, end,
+		addattr(t,
 			uiprivFUTURE_pango_attr_foreground_alpha_new(
 				(guint16) (a * 65535.0)));
 		break;
 	case uiAttributeTypeBackground:
 		// TODO make sure this works properly with line paragraph spacings (after figuring out what that means, of course)
 		uiAttributeColor(attr, &r, &g, &b, &a);
-		addattr(p, start, end,
+		addattr(t,
 			pango_attr_background_new(
 				(guint16) (r * 65535.0),
 				(guint16) (g * 65535.0),
 				(guint16) (b * 65535.0)));
-		addattr(p, start, end,
+		addattr(t,
 			uiprivFUTURE_pango_attr_background_alpha_new(
 				(guint16) (a * 65535.0)));
 		break;
@@ -87,14 +137,14 @@ static uiForEach processAttribute(const uiAttributedString *s, const uiAttribute
 			underline = PANGO_UNDERLINE_ERROR;
 			break;
 		}
-		addattr(p, start, end,
+		addattr(t,
 			pango_attr_underline_new(underline));
 		break;
 	case uiAttributeTypeUnderlineColor:
 		uiAttributeUnderlineColor(attr, &colorType, &r, &g, &b, &a);
 		switch (colorType) {
 		case uiUnderlineColorCustom:
-			addattr(p, start, end,
+			addattr(t,
 				pango_attr_underline_color_new(
 					(guint16) (r * 65535.0),
 					(guint16) (g * 65535.0),
@@ -102,17 +152,17 @@ static uiForEach processAttribute(const uiAttributedString *s, const uiAttribute
 			break;
 		case uiUnderlineColorSpelling:
 			// TODO GtkTextView style property error-underline-color
-			addattr(p, start, end,
+			addattr(t,
 				pango_attr_underline_color_new(65535, 0, 0));
 			break;
 		case uiUnderlineColorGrammar:
 			// TODO find a more appropriate color
-			addattr(p, start, end,
+			addattr(t,
 				pango_attr_underline_color_new(0, 65535, 0));
 			break;
 		case uiUnderlineColorAuxiliary:
 			// TODO find a more appropriate color
-			addattr(p, start, end,
+			addattr(t,
 				pango_attr_underline_color_new(0, 0, 65535));
 			break;
 		}
@@ -123,15 +173,54 @@ static uiForEach processAttribute(const uiAttributedString *s, const uiAttribute
 		features = uiAttributeFeatures(attr);
 		if (features == NULL)
 			break;
-		featurestr = uiprivOpenTypeFeaturesToPangoCSSFeaturesString(features);
-		addattr(p, start, end,
-			uiprivFUTURE_pango_attr_font_features_new(featurestr->str));
-		g_string_free(featurestr, TRUE);
+		addattr(t,
+			uiprivFUTURE_pango_attr_font_features_new(
+				uiprivOpenTypeFeaturesToPangoCSSFeaturesString(features)));
 		break;
 	default:
 		// TODO complain
 		;
 	}
+}
+
+static const struct template *attributeTemplate(const uiAttribute *attr)
+{
+	struct template *t, *existing;
+
+	t = (struct template *) uiprivAttributeOSData(attr);
+	if (t != NULL)
+		return t;
+
+	if (templates == NULL)
+		templates = g_hash_table_new(templateHash, templateEqual);
+	t = g_new0(struct template, 1);
+	convertAttribute(attr, t);
+	t->hash = (guint) uiprivAttributeHash(attr);
+	existing = (struct template *) g_hash_table_lookup(templates, t);
+	if (existing != NULL) {
+		freeTemplate(t);
+		t = existing;
+	} else
+		g_hash_table_add(templates, t);
+	t->refcount++;
+	uiprivAttributeSetOSData(attr, t, unrefTemplate);
+	return t;
+}
+
+static uiForEach processAttribute(const uiAttributedString *s, const uiAttribute *attr, size_t start, size_t end, void *data)
+{
+	struct foreachParams *p = (struct foreachParams *) data;
+	const struct template *t;
+	PangoAttribute *pa;
+	int i;
+
+	t = attributeTemplate(attr);
+	for (i = 0; i < t->n; i++) {
+		pa = pango_attribute_copy(t->attrs[i]);
+		pa->start_index = start;
+		pa->end_index = end;
+		pango_attr_list_insert(p->attrs, pa);
+	}
 	return uiForEachContinue;
 }
 
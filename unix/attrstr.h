@@ -6,14 +6,22 @@
 #define pangoToCairo(pango) (pango_units_to_double(pango))
 #define cairoToPango(cairo) (pango_units_from_double(cairo))
 
+// we need a context for a few things
+// the documentation suggests creating cairo_t-specific, GdkScreen-specific, or even GtkWidget-specific contexts, but we can't really do that because we want our uiDrawGlyphFonts and uiDrawTextLayouts to be context-independent
+// we could use pango_font_map_create_context(pango_cairo_font_map_get_default()) but that will ignore GDK-specific settings
+// so let's use gdk_pango_context_get() instead; even though it's for the default screen only, it's good enough for us
+// that needs a display, though, so after uiInitHeadless() we do have to fall back to the plain Pango context
+extern PangoContext *uiprivMkGenericPangoCairoContext(void);		// in drawtext.c
+
 // opentype.c
-extern GString *uiprivOpenTypeFeaturesToPangoCSSFeaturesString(const uiOpenTypeFeatures *otf);
+extern const char *uiprivOpenTypeFeaturesToPangoCSSFeaturesString(const uiOpenTypeFeatures *otf);
 
 // fontmatch.c
 extern PangoWeight uiprivWeightToPangoWeight(uiTextWeight w);
 extern PangoStyle uiprivItalicToPangoStyle(uiTextItalic i);
 extern PangoStretch uiprivStretchToPangoStretch(uiTextStretch s);
 extern PangoFontDescription *uiprivFontDescriptorToPangoFontDescription(const uiFontDescriptor *uidesc);
+extern const PangoFontDescription *uiprivCachedPangoFontDescription(const uiFontDescriptor *uidesc);
 extern void uiprivFontDescriptorFromPangoFontDescription(PangoFontDescription *pdesc, uiFontDescriptor *uidesc);
 
 // attrstr.c
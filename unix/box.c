@@ -4,6 +4,8 @@
 struct boxChild {
 	uiControl *c;
 	int stretchy;
+	// FALSE for stretchy controls appended during a uiControlBeginUpdate() until the matching uiControlEndUpdate()
+	gboolean grouped;
 	gboolean oldhexpand;
 	GtkAlign oldhalign;
 	gboolean oldvexpand;
@@ -31,6 +33,8 @@ static void uiBoxDestroy(uiControl *c)
 	struct boxChild *bc;
 	guint i;
 
+	// if we're inside an update that hasn't ended yet, it mustn't call groupStretchy() on us anymore
+	uiprivControlDeferUpdate(uiControl(b), NULL);
 	// kill the size group
 	g_object_unref(b->stretchygroup);
 	// free all controls
@@ -47,6 +51,22 @@ static void uiBoxDestroy(uiControl *c)
 	uiFreeControl(uiControl(b));
 }
 
+// adding a widget to a GtkSizeGroup re-queues a resize on every widget already in it, so appending n stretchy controls one by one costs O(n^2); during an update we add them all at the end instead
+static void groupStretchy(uiControl *c)
+{
+	uiBox *b = uiBox(c);
+	struct boxChild *bc;
+	guint i;
+
+	for (i = 0; i < b->controls->len; i++) {
+		bc = ctrl(b, i);
+		if (bc->stretchy && !bc->grouped) {
+			gtk_size_group_add_widget(b->stretchygroup, GTK_WIDGET(uiControlHandle(bc->c)));
+			bc->grouped = TRUE;
+		}
+	}
+}
+
 void uiBoxAppend(uiBox *b, uiControl *c, int stretchy)
 {
 	struct boxChild bc;
@@ -54,6 +74,7 @@ void uiBoxAppend(uiBox *b, uiControl *c, int stretchy)
 
 	bc.c = c;
 	bc.stretchy = stretchy;
+	bc.grouped = FALSE;
 	widget = GTK_WIDGET(uiControlHandle(bc.c));
 	bc.oldhexpand = gtk_widget_get_hexpand(widget);
 	bc.oldhalign = gtk_widget_get_halign(widget);
@@ -68,7 +89,12 @@ void uiBoxAppend(uiBox *b, uiControl *c, int stretchy)
 			gtk_widget_set_hexpand(widget, TRUE);
 			gtk_widget_set_halign(widget, GTK_ALIGN_FILL);
 		}
-		gtk_size_group_add_widget(b->stretchygroup, widget);
+		if (uiprivControlUpdating(uiControl(b)))
+			uiprivControlDeferUpdate(uiControl(b), groupStretchy);
+		else {
+			gtk_size_group_add_widget(b->stretchygroup, widget);
+			bc.grouped = TRUE;
+		}
 	} else
 		if (b->vertical)
 			gtk_widget_set_vexpand(widget, FALSE);
@@ -99,7 +125,7 @@ void uiBoxDelete(uiBox *b, int index)
 	uiControlSetParent(bc->c, NULL);
 	uiUnixControlSetContainer(uiUnixControl(bc->c), b->container, TRUE);
 
-	if (bc->stretchy)
+	if (bc->grouped)
 		gtk_size_group_remove_widget(b->stretchygroup, widget);
 	gtk_widget_set_hexpand(widget, bc->oldhexpand);
 	gtk_widget_set_halign(widget, bc->oldhalign);
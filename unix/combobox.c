@@ -9,6 +9,8 @@ struct uiCombobox {
 	void (*onSelected)(uiCombobox *, void *);
 	void *onSelectedData;
 	gulong onSelectedSignal;
+	const char *(*item)(uiCombobox *, int, void *);
+	void *itemData;
 };
 
 uiUnixControlAllDefaults(uiCombobox)
@@ -27,19 +29,40 @@ static void defaultOnSelected(uiCombobox *c, void *data)
 
 void uiComboboxAppend(uiCombobox *c, const char *text)
 {
+	if (uiprivComboBoxIsVirtual(c->combobox))
+		uiprivUserBug("You cannot call uiComboboxAppend() on a uiCombobox with virtual items. (combobox: %p)", c);
 	gtk_combo_box_text_append(c->comboboxText, NULL, text);
 }
 
+void uiComboboxSetItems(uiCombobox *c, const char *const *items, int n)
+{
+	uiprivComboBoxSetModel(c->combobox, uiprivNewComboListModel(items, n), c->onSelectedSignal);
+}
+
+static const char *virtualItem(gpointer owner, int i)
+{
+	uiCombobox *c = uiCombobox(owner);
+
+	return (*(c->item))(c, i, c->itemData);
+}
+
+void uiComboboxSetVirtualItems(uiCombobox *c, int n, const char *(*item)(uiCombobox *c, int i, void *data), void *data)
+{
+	c->item = item;
+	c->itemData = data;
+	uiprivComboBoxSetVirtualModel(c->combobox, uiprivNewComboVirtualModel(n, virtualItem, c), c->onSelectedSignal);
+}
+
 int uiComboboxSelected(uiCombobox *c)
 {
-	return gtk_combo_box_get_active(c->combobox);
+	return uiprivComboBoxActive(c->combobox);
 }
 
 void uiComboboxSetSelected(uiCombobox *c, int n)
 {
 	// we need to inhibit sending of ::changed because this WILL send a ::changed otherwise
 	g_signal_handler_block(c->combobox, c->onSelectedSignal);
-	gtk_combo_box_set_active(c->combobox, n);
+	uiprivComboBoxSetActive(c->combobox, n);
 	g_signal_handler_unblock(c->combobox, c->onSelectedSignal);
 }
 
@@ -0,0 +1,468 @@
+// 19 october 2026
+#include "uipriv_unix.h"
+
+// GtkComboBoxText keeps its items in a two-column GtkListStore: the text, then an ID we don't use
+// both kinds of model here have the same shape, so the GtkComboBoxText's cell renderer (and the entry of an editable combobox) keep working with either
+
+// with nothing attached to it, filling a GtkListStore doesn't make anything re-measure
+GtkTreeModel *uiprivNewComboListModel(const char *const *items, int n)
+{
+	GtkListStore *store;
+	int i;
+
+	store = gtk_list_store_new(2, G_TYPE_STRING, G_TYPE_STRING);
+	for (i = 0; i < n; i++)
+		gtk_list_store_insert_with_values(store, NULL, -1,
+			0, items[i],
+			-1);
+	return GTK_TREE_MODEL(store);
+}
+
+#define comboModelType (comboModel_get_type())
+#define comboModel(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), comboModelType, comboModel))
+#define isComboModel(obj) (G_TYPE_CHECK_INSTANCE_TYPE((obj), comboModelType))
+#define comboModelClass(class) (G_TYPE_CHECK_CLASS_CAST((class), comboModelType, comboModelClass))
+#define isComboModelClass(class) (G_TYPE_CHECK_CLASS_TYPE((class), comboModel))
+#define getComboModelClass(obj) (G_TYPE_INSTANCE_GET_CLASS((obj), comboModelType, comboModelClass))
+
+typedef struct comboModel comboModel;
+typedef struct comboModelClass comboModelClass;
+
+struct comboModel {
+	GObject parent_instance;
+	gint n;
+	uiprivComboModelItemFunc f;
+	gpointer owner;
+};
+
+struct comboModelClass {
+	GObjectClass parent_class;
+};
+
+static void comboModel_gtk_tree_model_interface_init(GtkTreeModelIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE(comboModel, comboModel, G_TYPE_OBJECT,
+	G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_MODEL, comboModel_gtk_tree_model_interface_init))
+
+static void comboModel_init(comboModel *m)
+{
+	// nothing to do
+}
+
+static void comboModel_dispose(GObject *obj)
+{
+	G_OBJECT_CLASS(comboModel_parent_class)->dispose(obj);
+}
+
+static void comboModel_finalize(GObject *obj)
+{
+	G_OBJECT_CLASS(comboModel_parent_class)->finalize(obj);
+}
+
+static GtkTreeModelFlags comboModel_get_flags(GtkTreeModel *mm)
+{
+	return GTK_TREE_MODEL_LIST_ONLY | GTK_TREE_MODEL_ITERS_PERSIST;
+}
+
+static gint comboModel_get_n_columns(GtkTreeModel *mm)
+{
+	return 2;
+}
+
+static GType comboModel_get_column_type(GtkTreeModel *mm, gint index)
+{
+	return G_TYPE_STRING;
+}
+
+#define STAMP_GOOD 0x1234
+#define STAMP_BAD 0x5678
+
+static gboolean setIter(comboModel *m, GtkTreeIter *iter, gint row)
+{
+	if (row < 0 || row >= m->n) {
+		iter->stamp = STAMP_BAD;
+		return FALSE;
+	}
+	iter->stamp = STAMP_GOOD;
+	iter->user_data = GINT_TO_POINTER(row);
+	return TRUE;
+}
+
+static gboolean comboModel_get_iter(GtkTreeModel *mm, GtkTreeIter *iter, GtkTreePath *path)
+{
+	comboModel *m = comboModel(mm);
+
+	if (gtk_tree_path_get_depth(path) != 1) {
+		iter->stamp = STAMP_BAD;
+		return FALSE;
+	}
+	return setIter(m, iter, gtk_tree_path_get_indices(path)[0]);
+}
+
+// GtkListStore returns NULL on error; let's do that too
+static GtkTreePath *comboModel_get_path(GtkTreeModel *mm, GtkTreeIter *iter)
+{
+	if (iter->stamp != STAMP_GOOD)
+		return NULL;
+	return gtk_tree_path_new_from_indices(GPOINTER_TO_INT(iter->user_data), -1);
+}
+
+// GtkListStore leaves value empty on failure; let's do the same
+static void comboModel_get_value(GtkTreeModel *mm, GtkTreeIter *iter, gint column, GValue *value)
+{
+	comboModel *m = comboModel(mm);
+
+	if (iter->stamp != STAMP_GOOD)
+		return;
+	g_value_init(value, G_TYPE_STRING);
+	if (column == 0)
+		// this copies, so the string only needs to last until the next call
+		g_value_set_string(value, (*(m->f))(m->owner, GPOINTER_TO_INT(iter->user_data)));
+}
+
+static gboolean comboModel_iter_next(GtkTreeModel *mm, GtkTreeIter *iter)
+{
+	comboModel *m = comboModel(mm);
+
+	if (iter->stamp != STAMP_GOOD)
+		return FALSE;
+	return setIter(m, iter, GPOINTER_TO_INT(iter->user_data) + 1);
+}
+
+static gboolean comboModel_iter_previous(GtkTreeModel *mm, GtkTreeIter *iter)
+{
+	comboModel *m = comboModel(mm);
+
+	if (iter->stamp != STAMP_GOOD)
+		return FALSE;
+	return setIter(m, iter, GPOINTER_TO_INT(iter->user_data) - 1);
+}
+
+static gboolean comboModel_iter_children(GtkTreeModel *mm, GtkTreeIter *iter, GtkTreeIter *parent)
+{
+	return gtk_tree_model_iter_nth_child(mm, iter, parent, 0);
+}
+
+static gboolean comboModel_iter_has_child(GtkTreeModel *mm, GtkTreeIter *iter)
+{
+	return FALSE;
+}
+
+static gint comboModel_iter_n_children(GtkTreeModel *mm, GtkTreeIter *iter)
+{
+	comboModel *m = comboModel(mm);
+
+	if (iter != NULL)
+		return 0;
+	return m->n;
+}
+
+static gboolean comboModel_iter_nth_child(GtkTreeModel *mm, GtkTreeIter *iter, GtkTreeIter *parent, gint n)
+{
+	comboModel *m = comboModel(mm);
+
+	if (parent != NULL) {
+		iter->stamp = STAMP_BAD;
+		return FALSE;
+	}
+	return setIter(m, iter, n);
+}
+
+static gboolean comboModel_iter_parent(GtkTreeModel *mm, GtkTreeIter *iter, GtkTreeIter *child)
+{
+	iter->stamp = STAMP_BAD;
+	return FALSE;
+}
+
+static void comboModel_class_init(comboModelClass *class)
+{
+	G_OBJECT_CLASS(class)->dispose = comboModel_dispose;
+	G_OBJECT_CLASS(class)->finalize = comboModel_finalize;
+}
+
+static void comboModel_gtk_tree_model_interface_init(GtkTreeModelIface *iface)
+{
+	iface->get_flags = comboModel_get_flags;
+	iface->get_n_columns = comboModel_get_n_columns;
+	iface->get_column_type = comboModel_get_column_type;
+	iface->get_iter = comboModel_get_iter;
+	iface->get_path = comboModel_get_path;
+	iface->get_value = comboModel_get_value;
+	iface->iter_next = comboModel_iter_next;
+	iface->iter_previous = comboModel_iter_previous;
+	iface->iter_children = comboModel_iter_children;
+	iface->iter_has_child = comboModel_iter_has_child;
+	iface->iter_n_children = comboModel_iter_n_children;
+	iface->iter_nth_child = comboModel_iter_nth_child;
+	iface->iter_parent = comboModel_iter_parent;
+	// don't specify ref_node() or unref_node()
+}
+
+// nothing is stored; the text of each item is asked for with f only when GTK+ needs it
+// this alone isn't enough to make a big combobox cheap; see uiprivComboBoxSetVirtualModel() below
+GtkTreeModel *uiprivNewComboVirtualModel(int n, uiprivComboModelItemFunc f, gpointer owner)
+{
+	comboModel *m;
+
+	if (n < 0)
+		uiprivUserBug("You cannot give a combobox a negative number of items. (count: %d)", n);
+	m = comboModel(g_object_new(comboModelType, NULL));
+	m->n = n;
+	m->f = f;
+	m->owner = owner;
+	return GTK_TREE_MODEL(m);
+}
+
+// In its default menu mode, a GtkComboBox builds a GtkMenuItem and a GtkCellView for every row the moment it gets a model, and its own GtkCellView measures every row to pick a width; with a virtual model that means asking for every item up front.
+// In list mode, the popup is a GtkTreeView instead, and a GtkTreeView in fixed-height mode only measures one row and only asks for the rows it actually draws. So virtual comboboxes are asked to switch to list mode.
+// The only way to ask is the (deprecated) appears-as-list style property, and that only takes effect the next time the combobox's style is updated. Until then, the model is held back here, so the menu never sees it.
+// There's also no API to get at the GtkTreeView. The list mode popup is a popup window attached to the combobox, so that's looked for first; the popup's accessible object is the GtkTreeView's too, but only if accessibility is on.
+// None of that is guaranteed, so if the GtkTreeView can't be found once the style is updated, the items are copied into a GtkListStore instead, the same as uiComboboxSetItems(). That costs a call to the item function for every item, but it never leaves the combobox empty, and it never hands a virtual model to a menu.
+
+static const char *listModeCSS = "* { -GtkComboBox-appears-as-list: true; }";
+
+struct virtualState {
+	GtkCssProvider *provider;
+	GtkTreeModel *pending;		// NULL once the combobox has it
+	gint pendingActive;
+	gulong changedSignal;
+	gboolean virtual;		// still TRUE if the items had to be copied
+	gboolean styled;		// the provider has taken effect, so there's no style update left to wait for
+};
+
+// this is freed by GObject when the combobox goes away, so don't use uiprivAlloc()
+static void freeVirtualState(gpointer data)
+{
+	struct virtualState *s = (struct virtualState *) data;
+
+	if (s->pending != NULL)
+		g_object_unref(s->pending);
+	g_object_unref(s->provider);
+	g_free(s);
+}
+
+static struct virtualState *virtualState(GtkComboBox *cb)
+{
+	return (struct virtualState *) g_object_get_data(G_OBJECT(cb), "uiprivComboVirtualState");
+}
+
+static GtkTreeView *findTreeView(GtkWidget *w)
+{
+	GList *children, *l;
+	GtkTreeView *tv;
+
+	if (GTK_IS_TREE_VIEW(w))
+		return GTK_TREE_VIEW(w);
+	if (!GTK_IS_CONTAINER(w))
+		return NULL;
+	tv = NULL;
+	children = gtk_container_get_children(GTK_CONTAINER(w));
+	for (l = children; l != NULL; l = l->next) {
+		tv = findTreeView(GTK_WIDGET(l->data));
+		if (tv != NULL)
+			break;
+	}
+	g_list_free(children);
+	return tv;
+}
+
+static GtkTreeView *listModeTreeView(GtkComboBox *cb)
+{
+	GList *toplevels, *l;
+	GtkWindow *popup;
+	GtkTreeView *tv;
+	AtkObject *acc;
+	GtkWidget *w;
+
+	// the menu of menu mode is attached to the combobox too, but has no GtkTreeView in it
+	tv = NULL;
+	toplevels = gtk_window_list_toplevels();
+	for (l = toplevels; l != NULL; l = l->next) {
+		popup = GTK_WINDOW(l->data);
+		if (gtk_window_get_window_type(popup) != GTK_WINDOW_POPUP)
+			continue;
+		if (gtk_window_get_attached_to(popup) != GTK_WIDGET(cb))
+			continue;
+		tv = findTreeView(GTK_WIDGET(popup));
+		if (tv != NULL)
+			break;
+	}
+	g_list_free(toplevels);
+	if (tv != NULL)
+		return tv;
+
+	acc = gtk_combo_box_get_popup_accessible(cb);
+	if (acc == NULL || !GTK_IS_ACCESSIBLE(acc))
+		return NULL;
+	w = gtk_accessible_get_widget(GTK_ACCESSIBLE(acc));
+	if (w == NULL || !GTK_IS_TREE_VIEW(w))
+		return NULL;
+	return GTK_TREE_VIEW(w);
+}
+
+// the GtkCellView that shows the current item sizes itself to fit every item unless told not to
+static void setFitModel(GtkComboBox *cb, gboolean fit)
+{
+	GtkWidget *child;
+
+	child = gtk_bin_get_child(GTK_BIN(cb));
+	if (child != NULL && GTK_IS_CELL_VIEW(child))
+		gtk_cell_view_set_fit_model(GTK_CELL_VIEW(child), fit);
+}
+
+static void setModel(GtkComboBox *cb, GtkTreeModel *m, gulong changedSignal)
+{
+	// the selection goes away with the old model, so don't let that look like the user did something
+	g_signal_handler_block(cb, changedSignal);
+	gtk_combo_box_set_model(cb, m);
+	g_signal_handler_unblock(cb, changedSignal);
+}
+
+// m replaces the pending model, whether it is the pending model or a copy of it
+static void attach(GtkComboBox *cb, struct virtualState *s, GtkTreeModel *m)
+{
+	setModel(cb, m, s->changedSignal);
+	g_object_unref(s->pending);
+	s->pending = NULL;
+	if (s->pendingActive != -1) {
+		g_signal_handler_block(cb, s->changedSignal);
+		gtk_combo_box_set_active(cb, s->pendingActive);
+		g_signal_handler_unblock(cb, s->changedSignal);
+	}
+}
+
+// returns FALSE if the combobox isn't in list mode yet, or if we can't tell
+static gboolean attachPending(GtkComboBox *cb, struct virtualState *s)
+{
+	GtkTreeView *tv;
+	GList *columns, *l;
+
+	tv = listModeTreeView(cb);
+	if (tv == NULL)
+		return FALSE;
+	// fixed-height mode requires every column to be fixed-size; the combobox makes the column fill the popup anyway
+	columns = gtk_tree_view_get_columns(tv);
+	for (l = columns; l != NULL; l = l->next)
+		gtk_tree_view_column_set_sizing(GTK_TREE_VIEW_COLUMN(l->data), GTK_TREE_VIEW_COLUMN_FIXED);
+	g_list_free(columns);
+	gtk_tree_view_set_fixed_height_mode(tv, TRUE);
+	// type-ahead search would ask for every item
+	gtk_tree_view_set_enable_search(tv, FALSE);
+
+	attach(cb, s, s->pending);
+	return TRUE;
+}
+
+static void attachCopy(GtkComboBox *cb, struct virtualState *s)
+{
+	comboModel *m = comboModel(s->pending);
+	GtkListStore *store;
+	gint i;
+
+	store = gtk_list_store_new(2, G_TYPE_STRING, G_TYPE_STRING);
+	for (i = 0; i < m->n; i++)
+		// this copies, so the string only needs to last until the next call
+		gtk_list_store_insert_with_values(store, NULL, -1,
+			0, (*(m->f))(m->owner, i),
+			-1);
+	attach(cb, s, GTK_TREE_MODEL(store));
+	// the combobox holds its own reference
+	g_object_unref(store);
+}
+
+// this is connected after GtkComboBox's own handler, which is what switches modes
+static void onStyleUpdated(GtkWidget *w, gpointer data)
+{
+	GtkComboBox *cb = GTK_COMBO_BOX(w);
+	struct virtualState *s;
+
+	s = virtualState(cb);
+	s->styled = TRUE;
+	if (s->pending == NULL)
+		return;
+	if (!attachPending(cb, s))
+		attachCopy(cb, s);
+}
+
+void uiprivComboBoxSetVirtualModel(GtkComboBox *cb, GtkTreeModel *m, gulong changedSignal)
+{
+	struct virtualState *s;
+
+	s = virtualState(cb);
+	if (s == NULL) {
+		s = g_new0(struct virtualState, 1);
+		s->provider = gtk_css_provider_new();
+		gtk_css_provider_load_from_data(s->provider, listModeCSS, -1, NULL);
+		gtk_style_context_add_provider(gtk_widget_get_style_context(GTK_WIDGET(cb)),
+			GTK_STYLE_PROVIDER(s->provider),
+			GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+		g_signal_connect_after(cb, "style-updated", G_CALLBACK(onStyleUpdated), NULL);
+		g_object_set_data_full(G_OBJECT(cb), "uiprivComboVirtualState", s, freeVirtualState);
+	}
+	if (s->pending != NULL)
+		g_object_unref(s->pending);
+	// we take the caller's reference
+	s->pending = m;
+	s->pendingActive = -1;
+	s->changedSignal = changedSignal;
+	s->virtual = TRUE;
+
+	setModel(cb, NULL, changedSignal);
+	setFitModel(cb, FALSE);
+	if (attachPending(cb, s))
+		return;
+	// the first style update after the provider was added is when list mode can be confirmed; if that's already happened, don't wait for another one
+	if (s->styled)
+		attachCopy(cb, s);
+}
+
+void uiprivComboBoxSetModel(GtkComboBox *cb, GtkTreeModel *m, gulong changedSignal)
+{
+	struct virtualState *s;
+
+	// once a combobox is in list mode it stays there; a GtkListStore works just as well with either
+	s = virtualState(cb);
+	if (s != NULL) {
+		if (s->pending != NULL) {
+			g_object_unref(s->pending);
+			s->pending = NULL;
+		}
+		s->virtual = FALSE;
+	}
+	setFitModel(cb, TRUE);
+	setModel(cb, m, changedSignal);
+	// the combobox holds its own reference
+	g_object_unref(m);
+}
+
+gboolean uiprivComboBoxIsVirtual(GtkComboBox *cb)
+{
+	struct virtualState *s;
+
+	s = virtualState(cb);
+	return s != NULL && s->virtual;
+}
+
+gint uiprivComboBoxActive(GtkComboBox *cb)
+{
+	struct virtualState *s;
+
+	s = virtualState(cb);
+	if (s != NULL && s->pending != NULL)
+		return s->pendingActive;
+	return gtk_combo_box_get_active(cb);
+}
+
+void uiprivComboBoxSetActive(GtkComboBox *cb, gint n)
+{
+	struct virtualState *s;
+
+	s = virtualState(cb);
+	if (s != NULL && s->pending != NULL) {
+		if (n < -1 || n >= gtk_tree_model_iter_n_children(s->pending, NULL))
+			n = -1;
+		s->pendingActive = n;
+		return;
+	}
+	gtk_combo_box_set_active(cb, n);
+}
@@ -12,3 +12,214 @@ uiUnixControl *uiUnixAllocControl(size_t n, uint32_t typesig, const char *typena
 {
 	return uiUnixControl(uiAllocControl(n, uiUnixControlSignature, typesig, typenamestr));
 }
+
+// uiControlBeginUpdate() and uiControlEndUpdate()
+// GTK+ already defers layout to the next frame, so what makes rebuilding a big container slow is the work each change does right away (for instance, every widget added to a GtkSizeGroup re-queues a resize on every other widget in the group) and the frames drawn halfway through
+// so we keep the control's last drawn contents on screen, and containers check uiprivControlUpdating() to put off their expensive parts until uiControlEndUpdate() runs the function they gave to uiprivControlDeferUpdate()
+// a control with its own GdkWindow has that frozen; most containers (uiBox and uiGrid included) don't have one, and gtk_widget_get_window() would give us the toplevel's, so for those we draw the control once into a surface and have ::draw show that instead, which also keeps their children from being drawn
+// the bracket covers c's children too, so a container checks its ancestors as well, and its deferred work is run by the outermost one that's updating
+struct update {
+	uiControl *c;
+	guint depth;
+	GdkWindow *frozen;
+	cairo_surface_t *snapshot;
+	void (*deferred)(uiControl *);
+	struct update *owner;		// the update whose uiControlEndUpdate() runs deferred
+	GPtrArray *pending;		// of struct update *; the ones whose owner is this one
+};
+
+#define updateKey "libui-update"
+
+static struct update *getUpdate(uiControl *c)
+{
+	return (struct update *) g_object_get_data(G_OBJECT(uiControlHandle(c)), updateKey);
+}
+
+static void thaw(struct update *u)
+{
+	if (u->frozen != NULL) {
+		gdk_window_thaw_updates(u->frozen);
+		g_object_unref(u->frozen);
+		u->frozen = NULL;
+	}
+	if (u->snapshot != NULL) {
+		cairo_surface_destroy(u->snapshot);
+		u->snapshot = NULL;
+	}
+}
+
+static void cancelDeferred(struct update *u)
+{
+	u->deferred = NULL;
+	if (u->owner == NULL)
+		return;
+	g_ptr_array_remove(u->owner->pending, u);
+	u->owner = NULL;
+}
+
+// this runs when the widget is destroyed, so a control destroyed between uiControlBeginUpdate() and uiControlEndUpdate() doesn't leave its GdkWindow frozen or anything pointing at it
+// this is freed by GObject, possibly after uiUninit(), so it can't use uiprivAlloc()
+static void freeUpdate(gpointer data)
+{
+	struct update *u = (struct update *) data;
+	guint i;
+
+	thaw(u);
+	cancelDeferred(u);
+	for (i = 0; i < u->pending->len; i++) {
+		((struct update *) g_ptr_array_index(u->pending, i))->owner = NULL;
+		((struct update *) g_ptr_array_index(u->pending, i))->deferred = NULL;
+	}
+	g_ptr_array_free(u->pending, TRUE);
+	g_free(u);
+}
+
+static gboolean onDraw(GtkWidget *widget, cairo_t *cr, gpointer data)
+{
+	struct update *u = (struct update *) data;
+
+	if (u->depth == 0)
+		return FALSE;
+	if (u->snapshot != NULL) {
+		cairo_set_source_surface(cr, u->snapshot, 0, 0);
+		cairo_paint(cr);
+	}
+	// returning TRUE stops the default handler, and with it the drawing of any children
+	return TRUE;
+}
+
+static struct update *ensureUpdate(uiControl *c)
+{
+	GtkWidget *widget;
+	struct update *u;
+
+	u = getUpdate(c);
+	if (u != NULL)
+		return u;
+	widget = GTK_WIDGET(uiControlHandle(c));
+	u = g_new0(struct update, 1);
+	u->c = c;
+	u->pending = g_ptr_array_new();
+	g_object_set_data_full(G_OBJECT(widget), updateKey, u, freeUpdate);
+	if (!gtk_widget_get_has_window(widget))
+		g_signal_connect(widget, "draw", G_CALLBACK(onDraw), u);
+	return u;
+}
+
+static void snapshot(GtkWidget *widget, struct update *u)
+{
+	GtkAllocation a;
+	cairo_t *cr;
+
+	gtk_widget_get_allocation(widget, &a);
+	if (a.width <= 0 || a.height <= 0)
+		return;
+	u->snapshot = gdk_window_create_similar_surface(gtk_widget_get_window(widget),
+		CAIRO_CONTENT_COLOR_ALPHA, a.width, a.height);
+	cr = cairo_create(u->snapshot);
+	// u->depth is still 0 here, so onDraw() lets this through
+	gtk_widget_draw(widget, cr);
+	cairo_destroy(cr);
+}
+
+void uiControlBeginUpdate(uiControl *c)
+{
+	GtkWidget *widget;
+	struct update *u;
+
+	widget = GTK_WIDGET(uiControlHandle(c));
+	u = ensureUpdate(c);
+	// if the widget isn't on screen yet, there's nothing to keep from being drawn
+	if (u->depth == 0 && gtk_widget_is_drawable(widget)) {
+		if (gtk_widget_get_has_window(widget)) {
+			u->frozen = gtk_widget_get_window(widget);
+			g_object_ref(u->frozen);
+			gdk_window_freeze_updates(u->frozen);
+		} else
+			snapshot(widget, u);
+	}
+	u->depth++;
+}
+
+void uiControlEndUpdate(uiControl *c)
+{
+	GtkWidget *widget;
+	struct update *u, *p;
+	void (*deferred)(uiControl *);
+
+	widget = GTK_WIDGET(uiControlHandle(c));
+	u = getUpdate(c);
+	if (u == NULL || u->depth == 0)
+		uiprivUserBug("You cannot call uiControlEndUpdate() without a matching uiControlBeginUpdate(). (control: %p)", c);
+	u->depth--;
+	if (u->depth != 0)
+		return;
+	// deferred work of descendants first, then our own
+	while (u->pending->len != 0) {
+		p = (struct update *) g_ptr_array_index(u->pending, u->pending->len - 1);
+		deferred = p->deferred;
+		cancelDeferred(p);
+		if (deferred != NULL)
+			(*deferred)(p->c);
+	}
+	deferred = u->deferred;
+	u->deferred = NULL;
+	if (deferred != NULL)
+		(*deferred)(c);
+	// and lay everything out and draw it once
+	gtk_widget_queue_resize(widget);
+	// queue_resize() doesn't always redraw, and a widget whose ::draw we swallowed needs to be
+	if (u->frozen == NULL)
+		gtk_widget_queue_draw(widget);
+	thaw(u);
+}
+
+// returns the outermost control from c up whose update hasn't ended yet, or NULL if there isn't one
+static uiControl *updatingAncestor(uiControl *c)
+{
+	struct update *u;
+	uiControl *found;
+
+	found = NULL;
+	for (; c != NULL; c = uiControlParent(c)) {
+		u = getUpdate(c);
+		if (u != NULL && u->depth != 0)
+			found = c;
+	}
+	return found;
+}
+
+gboolean uiprivControlUpdating(uiControl *c)
+{
+	return updatingAncestor(c) != NULL;
+}
+
+// f is run by the uiControlEndUpdate() of c's outermost updating ancestor (which may be c itself); only the last f given for c is run
+// pass NULL to forget about a pending f, for instance because c is being destroyed
+void uiprivControlDeferUpdate(uiControl *c, void (*f)(uiControl *))
+{
+	uiControl *a;
+	struct update *u, *au;
+
+	u = getUpdate(c);
+	if (f == NULL) {
+		if (u != NULL)
+			cancelDeferred(u);
+		return;
+	}
+	a = updatingAncestor(c);
+	if (a == NULL)
+		uiprivImplBug("uiprivControlDeferUpdate() called on a control that isn't updating (control: %p)", c);
+	u = ensureUpdate(c);
+	au = getUpdate(a);
+	if (a != c && u->owner == au) {
+		u->deferred = f;
+		return;
+	}
+	cancelDeferred(u);
+	u->deferred = f;
+	if (a != c) {
+		u->owner = au;
+		g_ptr_array_add(au->pending, u);
+	}
+}
@@ -12,12 +12,36 @@ uiDrawContext *uiprivNewContext(cairo_t *cr, GtkStyleContext *style)
 	return c;
 }
 
+// a uiArea keeps its context from one frame to the next so the frame arena can be reused
+void uiprivContextBeginFrame(uiDrawContext *c, cairo_t *cr, GtkStyleContext *style)
+{
+	c->cr = cr;
+	c->style = style;
+}
+
+void uiprivContextEndFrame(uiDrawContext *c)
+{
+	if (c->arena != NULL)
+		uiprivArenaReset(c->arena);
+	c->cr = NULL;
+	c->style = NULL;
+}
+
 void uiprivFreeContext(uiDrawContext *c)
 {
 	// free neither cr nor style; we own neither
+	if (c->arena != NULL)
+		uiprivFreeArena(c->arena);
 	uiprivFree(c);
 }
 
+uiprivArena *uiprivContextArena(uiDrawContext *c)
+{
+	if (c->arena == NULL)
+		c->arena = uiprivNewArena();
+	return c->arena;
+}
+
 static cairo_pattern_t *mkbrush(uiDrawBrush *b)
 {
 	cairo_pattern_t *pat;
@@ -55,6 +79,16 @@ static cairo_pattern_t *mkbrush(uiDrawBrush *b)
 	return pat;
 }
 
+void uiprivSetSourceBrush(cairo_t *cr, uiDrawBrush *b)
+{
+	cairo_pattern_t *pat;
+
+	pat = mkbrush(b);
+	cairo_set_source(cr, pat);
+	// cairo_set_source() takes its own reference
+	cairo_pattern_destroy(pat);
+}
+
 void uiDrawStroke(uiDrawContext *c, uiDrawPath *path, uiDrawBrush *b, uiDrawStrokeParams *p)
 {
 	cairo_pattern_t *pat;
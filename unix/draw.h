@@ -4,7 +4,13 @@
 struct uiDrawContext {
 	cairo_t *cr;
 	GtkStyleContext *style;
+	// only for offscreen contexts; NULL for uiArea contexts
+	cairo_surface_t *surface;
+	// for uiDrawNewFramePath(); made on first use
+	uiprivArena *arena;
 };
+extern void uiprivSetSourceBrush(cairo_t *cr, uiDrawBrush *b);
+extern uiprivArena *uiprivContextArena(uiDrawContext *c);
 
 // drawpath.c
 extern void uiprivRunPath(uiDrawPath *p, cairo_t *cr);
@@ -0,0 +1,198 @@
+// 19 october 2026
+#include "uipriv_unix.h"
+#include "draw.h"
+#include "attrstr.h"
+
+// A uiDrawGlyphFont maps codepoints to glyphs once and then draws strings by looking the glyphs up again.
+// We go through a PangoFontset so codepoints the requested font doesn't cover still fall back to another font like they would in a PangoLayout; this means a single uiDrawGlyphRuns() call may need more than one font, so we keep one glyph buffer per font and issue one cairo_show_glyphs() per font instead of one per string.
+
+struct glyph {
+	gboolean valid;
+	unsigned long index;
+	double advance;
+	guint font;		// index into f->fonts
+};
+
+struct glyphFontFont {
+	PangoFont *font;
+	cairo_scaled_font_t *scaled;		// owned by font
+	GArray *buf;		// of cairo_glyph_t; reused between draws
+};
+
+#define nASCII 128
+
+struct uiDrawGlyphFont {
+	PangoContext *context;
+	PangoFontset *fontset;
+	double ascent;
+	double height;
+	GArray *fonts;		// of struct glyphFontFont
+	struct glyph ascii[nASCII];
+	GHashTable *others;		// gunichar -> struct glyph *
+};
+
+uiDrawGlyphFont *uiDrawNewGlyphFont(const uiFontDescriptor *desc)
+{
+	uiDrawGlyphFont *f;
+	const PangoFontDescription *pdesc;
+	PangoFontMetrics *metrics;
+
+	f = uiprivNew(uiDrawGlyphFont);
+	f->context = uiprivMkGenericPangoCairoContext();
+	pdesc = uiprivCachedPangoFontDescription(desc);
+	f->fontset = pango_context_load_fontset(f->context, pdesc, pango_context_get_language(f->context));
+	// use the metrics of the whole fontset so fallback glyphs fit in the same lines as everything else
+	metrics = pango_context_get_metrics(f->context, pdesc, NULL);
+	f->ascent = pangoToCairo(pango_font_metrics_get_ascent(metrics));
+	f->height = f->ascent + pangoToCairo(pango_font_metrics_get_descent(metrics));
+	pango_font_metrics_unref(metrics);
+
+	f->fonts = g_array_new(FALSE, TRUE, sizeof (struct glyphFontFont));
+	f->others = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+	return f;
+}
+
+void uiDrawFreeGlyphFont(uiDrawGlyphFont *f)
+{
+	struct glyphFontFont *ff;
+	guint i;
+
+	for (i = 0; i < f->fonts->len; i++) {
+		ff = &g_array_index(f->fonts, struct glyphFontFont, i);
+		g_array_free(ff->buf, TRUE);
+		g_object_unref(ff->font);
+	}
+	g_array_free(f->fonts, TRUE);
+	g_hash_table_destroy(f->others);
+	g_object_unref(f->fontset);
+	g_object_unref(f->context);
+	uiprivFree(f);
+}
+
+// takes ownership of font
+static guint fontIndex(uiDrawGlyphFont *f, PangoFont *font)
+{
+	struct glyphFontFont ff;
+	guint i;
+
+	// there is almost always just one font, and rarely more than a handful, so a linear search is fine
+	for (i = 0; i < f->fonts->len; i++)
+		if (g_array_index(f->fonts, struct glyphFontFont, i).font == font) {
+			g_object_unref(font);
+			return i;
+		}
+	ff.font = font;
+	ff.scaled = pango_cairo_font_get_scaled_font(PANGO_CAIRO_FONT(font));
+	ff.buf = g_array_new(FALSE, FALSE, sizeof (cairo_glyph_t));
+	g_array_append_val(f->fonts, ff);
+	return f->fonts->len - 1;
+}
+
+static void loadGlyph(uiDrawGlyphFont *f, gunichar ch, struct glyph *g)
+{
+	struct glyphFontFont *ff;
+	char utf8[6];
+	int n;
+	cairo_glyph_t *glyphs = NULL;
+	int nGlyphs = 0;
+	cairo_text_extents_t extents;
+
+	g->valid = TRUE;
+	g->font = fontIndex(f, pango_fontset_get_font(f->fontset, ch));
+	ff = &g_array_index(f->fonts, struct glyphFontFont, g->font);
+	n = g_unichar_to_utf8(ch, utf8);
+	if (ff->scaled == NULL ||
+		cairo_scaled_font_text_to_glyphs(ff->scaled, 0, 0,
+			utf8, n,
+			&glyphs, &nGlyphs,
+			NULL, NULL, NULL) != CAIRO_STATUS_SUCCESS ||
+		nGlyphs == 0) {
+		// draw nothing for this codepoint
+		g->index = 0;
+		g->advance = 0;
+		cairo_glyph_free(glyphs);
+		g->font = G_MAXUINT;
+		return;
+	}
+	g->index = glyphs[0].index;
+	cairo_scaled_font_glyph_extents(ff->scaled, glyphs, 1, &extents);
+	g->advance = extents.x_advance;
+	cairo_glyph_free(glyphs);
+}
+
+static const struct glyph *lookupGlyph(uiDrawGlyphFont *f, gunichar ch)
+{
+	struct glyph *g;
+
+	if (ch < nASCII) {
+		g = &(f->ascii[ch]);
+		if (!g->valid)
+			loadGlyph(f, ch, g);
+		return g;
+	}
+	g = (struct glyph *) g_hash_table_lookup(f->others, GUINT_TO_POINTER(ch));
+	if (g == NULL) {
+		g = g_new0(struct glyph, 1);
+		loadGlyph(f, ch, g);
+		g_hash_table_insert(f->others, GUINT_TO_POINTER(ch), g);
+	}
+	return g;
+}
+
+// returns the total advance of text, stopping at the first invalid UTF-8 sequence
+// if draw is set, the glyphs are also queued into the per-font buffers with their baseline origin at (x, y)
+static double walkText(uiDrawGlyphFont *f, const char *text, gboolean draw, double x, double y)
+{
+	const struct glyph *g;
+	struct glyphFontFont *ff;
+	cairo_glyph_t cg;
+	gunichar ch;
+	double pen;
+
+	pen = 0;
+	while (*text != '\0') {
+		ch = g_utf8_get_char_validated(text, -1);
+		if (ch == (gunichar) (-1) || ch == (gunichar) (-2))
+			break;
+		text = g_utf8_next_char(text);
+		g = lookupGlyph(f, ch);
+		if (draw && g->font != G_MAXUINT) {
+			ff = &g_array_index(f->fonts, struct glyphFontFont, g->font);
+			cg.index = g->index;
+			cg.x = x + pen;
+			cg.y = y;
+			g_array_append_val(ff->buf, cg);
+		}
+		pen += g->advance;
+	}
+	return pen;
+}
+
+void uiDrawGlyphRuns(uiDrawContext *c, uiDrawGlyphFont *f, const uiDrawGlyphRun *runs, size_t n, uiDrawBrush *b)
+{
+	struct glyphFontFont *ff;
+	size_t i;
+	guint j;
+
+	for (i = 0; i < n; i++)
+		walkText(f, runs[i].Text, TRUE, runs[i].X, runs[i].Y + f->ascent);
+
+	// the source and font are only for this call; don't leave them set on the caller's context
+	cairo_save(c->cr);
+	uiprivSetSourceBrush(c->cr, b);
+	for (j = 0; j < f->fonts->len; j++) {
+		ff = &g_array_index(f->fonts, struct glyphFontFont, j);
+		if (ff->buf->len == 0)
+			continue;
+		cairo_set_scaled_font(c->cr, ff->scaled);
+		cairo_show_glyphs(c->cr, (cairo_glyph_t *) (ff->buf->data), ff->buf->len);
+		g_array_set_size(ff->buf, 0);
+	}
+	cairo_restore(c->cr);
+}
+
+void uiDrawGlyphFontExtents(uiDrawGlyphFont *f, const char *text, double *width, double *height)
+{
+	*width = walkText(f, text, FALSE, 0, 0);
+	*height = f->height;
+}
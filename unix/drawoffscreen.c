@@ -0,0 +1,80 @@
+// 19 october 2026
+#include "uipriv_unix.h"
+#include "draw.h"
+#include <cairo-pdf.h>
+#include <cairo-svg.h>
+
+// none of this touches GTK+ or GDK, so it works after uiInitHeadless()
+
+static uiDrawContext *newOffscreenContext(cairo_surface_t *s)
+{
+	uiDrawContext *c;
+
+	if (cairo_surface_status(s) != CAIRO_STATUS_SUCCESS) {
+		cairo_surface_destroy(s);
+		return NULL;
+	}
+	c = uiprivNew(uiDrawContext);
+	c->surface = s;
+	c->cr = cairo_create(s);
+	// there's no widget to take a style from; nothing that draws into a uiDrawContext needs one yet
+	c->style = NULL;
+	return c;
+}
+
+uiDrawContext *uiDrawNewImageContext(int pixelWidth, int pixelHeight)
+{
+	uiDrawContext *c;
+
+	c = newOffscreenContext(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pixelWidth, pixelHeight));
+	if (c == NULL)
+		uiprivImplBug("error creating %dx%d offscreen image", pixelWidth, pixelHeight);
+	return c;
+}
+
+uiDrawContext *uiDrawNewPDFContext(const char *filename, double width, double height)
+{
+	return newOffscreenContext(cairo_pdf_surface_create(filename, width, height));
+}
+
+uiDrawContext *uiDrawNewSVGContext(const char *filename, double width, double height)
+{
+	return newOffscreenContext(cairo_svg_surface_create(filename, width, height));
+}
+
+static void checkOffscreen(uiDrawContext *c, cairo_surface_type_t type, const char *func)
+{
+	if (c->surface == NULL || cairo_surface_get_type(c->surface) != type)
+		uiprivUserBug("You cannot call %s() on this uiDrawContext. (context: %p)", func, c);
+}
+
+void uiDrawContextNewPage(uiDrawContext *c)
+{
+	checkOffscreen(c, CAIRO_SURFACE_TYPE_PDF, "uiDrawContextNewPage");
+	cairo_show_page(c->cr);
+}
+
+int uiDrawContextWritePNG(uiDrawContext *c, const char *filename)
+{
+	checkOffscreen(c, CAIRO_SURFACE_TYPE_IMAGE, "uiDrawContextWritePNG");
+	return cairo_surface_write_to_png(c->surface, filename) == CAIRO_STATUS_SUCCESS;
+}
+
+const void *uiDrawContextPixels(uiDrawContext *c, int *byteStride)
+{
+	checkOffscreen(c, CAIRO_SURFACE_TYPE_IMAGE, "uiDrawContextPixels");
+	cairo_surface_flush(c->surface);
+	*byteStride = cairo_image_surface_get_stride(c->surface);
+	return cairo_image_surface_get_data(c->surface);
+}
+
+void uiDrawFreeContext(uiDrawContext *c)
+{
+	if (c->surface == NULL)
+		uiprivUserBug("You cannot free the uiDrawContext given to a uiAreaHandler. (context: %p)", c);
+	cairo_destroy(c->cr);
+	// writes out the rest of the file for PDF and SVG surfaces
+	cairo_surface_finish(c->surface);
+	cairo_surface_destroy(c->surface);
+	uiprivFreeContext(c);
+}
@@ -2,135 +2,213 @@
 #include "uipriv_unix.h"
 #include "draw.h"
 
+// A path is stored as a stream of one-byte commands plus a separate packed array of the coordinates they use, in order.
+// A lineTo is thus 1 byte of command and 2 coordinates, instead of a fixed-size record big enough for a bezierTo.
+// Single-precision paths store their coordinates as floats, which halves the size of the coordinate array again; this is meant for large data plots, where 7 significant digits is more than the screen can show.
 struct uiDrawPath {
-	GArray *pieces;
+	uint8_t *cmds;
+	size_t nCmds;
+	size_t capCmds;
+	// double[] or float[], depending on single
+	void *coords;
+	size_t nCoords;
+	size_t capCoords;
+	gboolean single;
 	uiDrawFillMode fillMode;
 	gboolean ended;
-};
-
-struct piece {
-	int type;
-	double d[8];
-	int b;
+	// non-NULL for uiDrawNewFramePath() paths, which are allocated from and freed with this
+	uiprivArena *arena;
 };
 
 enum {
 	newFigure,
 	newFigureArc,
+	newFigureArcNegative,
 	lineTo,
 	arcTo,
+	arcToNegative,
 	bezierTo,
 	closeFigure,
 	addRect,
 };
 
-uiDrawPath *uiDrawNewPath(uiDrawFillMode mode)
+static uiDrawPath *newPath(uiDrawFillMode mode, gboolean single)
 {
 	uiDrawPath *p;
 
 	p = uiprivNew(uiDrawPath);
-	p->pieces = g_array_new(FALSE, TRUE, sizeof (struct piece));
 	p->fillMode = mode;
+	p->single = single;
+	return p;
+}
+
+uiDrawPath *uiDrawNewPath(uiDrawFillMode mode)
+{
+	return newPath(mode, FALSE);
+}
+
+uiDrawPath *uiDrawNewSinglePrecisionPath(uiDrawFillMode mode)
+{
+	return newPath(mode, TRUE);
+}
+
+uiDrawPath *uiDrawNewFramePath(uiDrawContext *c, uiDrawFillMode mode)
+{
+	uiDrawPath *p;
+	uiprivArena *arena;
+
+	arena = uiprivContextArena(c);
+	p = (uiDrawPath *) uiprivArenaAlloc(arena, sizeof (uiDrawPath));
+	p->fillMode = mode;
+	p->arena = arena;
 	return p;
 }
 
 void uiDrawFreePath(uiDrawPath *p)
 {
-	g_array_free(p->pieces, TRUE);
+	if (p->arena != NULL)
+		// freed with the rest of the frame
+		return;
+	if (p->cmds != NULL)
+		uiprivFree(p->cmds);
+	if (p->coords != NULL)
+		uiprivFree(p->coords);
 	uiprivFree(p);
 }
 
-static void add(uiDrawPath *p, struct piece *piece)
+#define coordSize(p) ((p)->single ? sizeof (float) : sizeof (double))
+
+static void *growTo(uiDrawPath *p, void *buf, size_t *cap, size_t need, size_t elemSize, const char *type)
+{
+	size_t n;
+
+	if (need <= *cap)
+		return buf;
+	n = *cap * 2;
+	if (n < need)
+		n = need;
+	if (p->arena != NULL)
+		buf = uiprivArenaRealloc(p->arena, buf, *cap * elemSize, n * elemSize);
+	else
+		buf = uiprivRealloc(buf, n * elemSize, type);
+	*cap = n;
+	return buf;
+}
+
+#define firstCap 16
+
+static void reserve(uiDrawPath *p, size_t nCmds, size_t nCoords)
+{
+	if (nCmds < firstCap)
+		nCmds = firstCap;
+	if (nCoords < 2 * firstCap)
+		nCoords = 2 * firstCap;
+	p->cmds = (uint8_t *) growTo(p, p->cmds, &(p->capCmds),
+		p->nCmds + nCmds, sizeof (uint8_t), "uint8_t[] (uiDrawPath)");
+	p->coords = growTo(p, p->coords, &(p->capCoords),
+		p->nCoords + nCoords, coordSize(p), p->single ? "float[] (uiDrawPath)" : "double[] (uiDrawPath)");
+}
+
+void uiDrawPathReserve(uiDrawPath *p, size_t n)
 {
 	if (p->ended)
 		uiprivUserBug("You cannot modify a uiDrawPath that has been ended. (path: %p)", p);
-	g_array_append_vals(p->pieces, piece, 1);
+	reserve(p, n, 2 * n);
+}
+
+static void add(uiDrawPath *p, uint8_t cmd, const double *d, size_t n)
+{
+	size_t i;
+	float *f;
+
+	if (p->ended)
+		uiprivUserBug("You cannot modify a uiDrawPath that has been ended. (path: %p)", p);
+	if (p->nCmds == p->capCmds || p->capCoords - p->nCoords < n)
+		reserve(p, 1, n);
+	p->cmds[p->nCmds] = cmd;
+	p->nCmds++;
+	if (p->single) {
+		f = ((float *) (p->coords)) + p->nCoords;
+		for (i = 0; i < n; i++)
+			f[i] = (float) d[i];
+	} else if (n != 0)
+		// uiDrawPathCloseFigure() passes d == NULL, and memcpy() from NULL is undefined even for 0 bytes
+		memcpy(((double *) (p->coords)) + p->nCoords, d, n * sizeof (double));
+	p->nCoords += n;
 }
 
 void uiDrawPathNewFigure(uiDrawPath *p, double x, double y)
 {
-	struct piece piece;
+	double d[2];
 
-	piece.type = newFigure;
-	piece.d[0] = x;
-	piece.d[1] = y;
-	add(p, &piece);
+	d[0] = x;
+	d[1] = y;
+	add(p, newFigure, d, 2);
 }
 
-void uiDrawPathNewFigureWithArc(uiDrawPath *p, double xCenter, double yCenter, double radius, double startAngle, double sweep, int negative)
+static void addArc(uiDrawPath *p, uint8_t cmd, double xCenter, double yCenter, double radius, double startAngle, double sweep)
 {
-	struct piece piece;
+	double d[5];
 
 	if (sweep > 2 * uiPi)
 		sweep = 2 * uiPi;
-	piece.type = newFigureArc;
-	piece.d[0] = xCenter;
-	piece.d[1] = yCenter;
-	piece.d[2] = radius;
-	piece.d[3] = startAngle;
-	piece.d[4] = sweep;
-	piece.b = negative;
-	add(p, &piece);
+	d[0] = xCenter;
+	d[1] = yCenter;
+	d[2] = radius;
+	d[3] = startAngle;
+	// store the end angle, since that's what cairo wants
+	d[4] = startAngle + sweep;
+	add(p, cmd, d, 5);
+}
+
+void uiDrawPathNewFigureWithArc(uiDrawPath *p, double xCenter, double yCenter, double radius, double startAngle, double sweep, int negative)
+{
+	addArc(p, negative ? newFigureArcNegative : newFigureArc,
+		xCenter, yCenter, radius, startAngle, sweep);
 }
 
 void uiDrawPathLineTo(uiDrawPath *p, double x, double y)
 {
-	struct piece piece;
+	double d[2];
 
-	piece.type = lineTo;
-	piece.d[0] = x;
-	piece.d[1] = y;
-	add(p, &piece);
+	d[0] = x;
+	d[1] = y;
+	add(p, lineTo, d, 2);
 }
 
 void uiDrawPathArcTo(uiDrawPath *p, double xCenter, double yCenter, double radius, double startAngle, double sweep, int negative)
 {
-	struct piece piece;
-
-	if (sweep > 2 * uiPi)
-		sweep = 2 * uiPi;
-	piece.type = arcTo;
-	piece.d[0] = xCenter;
-	piece.d[1] = yCenter;
-	piece.d[2] = radius;
-	piece.d[3] = startAngle;
-	piece.d[4] = sweep;
-	piece.b = negative;
-	add(p, &piece);
+	addArc(p, negative ? arcToNegative : arcTo,
+		xCenter, yCenter, radius, startAngle, sweep);
 }
 
 void uiDrawPathBezierTo(uiDrawPath *p, double c1x, double c1y, double c2x, double c2y, double endX, double endY)
 {
-	struct piece piece;
+	double d[6];
 
-	piece.type = bezierTo;
-	piece.d[0] = c1x;
-	piece.d[1] = c1y;
-	piece.d[2] = c2x;
-	piece.d[3] = c2y;
-	piece.d[4] = endX;
-	piece.d[5] = endY;
-	add(p, &piece);
+	d[0] = c1x;
+	d[1] = c1y;
+	d[2] = c2x;
+	d[3] = c2y;
+	d[4] = endX;
+	d[5] = endY;
+	add(p, bezierTo, d, 6);
 }
 
 void uiDrawPathCloseFigure(uiDrawPath *p)
 {
-	struct piece piece;
-
-	piece.type = closeFigure;
-	add(p, &piece);
+	add(p, closeFigure, NULL, 0);
 }
 
 void uiDrawPathAddRectangle(uiDrawPath *p, double x, double y, double width, double height)
 {
-	struct piece piece;
+	double d[4];
 
-	piece.type = addRect;
-	piece.d[0] = x;
-	piece.d[1] = y;
-	piece.d[2] = width;
-	piece.d[3] = height;
-	add(p, &piece);
+	d[0] = x;
+	d[1] = y;
+	d[2] = width;
+	d[3] = height;
+	add(p, addRect, d, 4);
 }
 
 void uiDrawPathEnd(uiDrawPath *p)
@@ -138,59 +216,57 @@ void uiDrawPathEnd(uiDrawPath *p)
 	p->ended = TRUE;
 }
 
+// the two precisions share one loop body
+#define runPath(T) \
+	{ \
+		const T *d = (const T *) (p->coords); \
+		for (i = 0; i < p->nCmds; i++) \
+			switch (p->cmds[i]) { \
+			case newFigure: \
+				cairo_move_to(cr, d[0], d[1]); \
+				d += 2; \
+				break; \
+			case lineTo: \
+				cairo_line_to(cr, d[0], d[1]); \
+				d += 2; \
+				break; \
+			case newFigureArc: \
+			case newFigureArcNegative: \
+				cairo_new_sub_path(cr); \
+				/* fall through */ \
+			case arcTo: \
+			case arcToNegative: \
+				if (p->cmds[i] == newFigureArcNegative || p->cmds[i] == arcToNegative) \
+					cairo_arc_negative(cr, d[0], d[1], d[2], d[3], d[4]); \
+				else \
+					cairo_arc(cr, d[0], d[1], d[2], d[3], d[4]); \
+				d += 5; \
+				break; \
+			case bezierTo: \
+				cairo_curve_to(cr, d[0], d[1], d[2], d[3], d[4], d[5]); \
+				d += 6; \
+				break; \
+			case closeFigure: \
+				cairo_close_path(cr); \
+				break; \
+			case addRect: \
+				cairo_rectangle(cr, d[0], d[1], d[2], d[3]); \
+				d += 4; \
+				break; \
+			} \
+	}
+
 void uiprivRunPath(uiDrawPath *p, cairo_t *cr)
 {
-	guint i;
-	struct piece *piece;
-	void (*arc)(cairo_t *, double, double, double, double, double);
+	size_t i;
 
 	if (!p->ended)
 		uiprivUserBug("You cannot draw with a uiDrawPath that has not been ended. (path: %p)", p);
 	cairo_new_path(cr);
-	for (i = 0; i < p->pieces->len; i++) {
-		piece = &g_array_index(p->pieces, struct piece, i);
-		switch (piece->type) {
-		case newFigure:
-			cairo_move_to(cr, piece->d[0], piece->d[1]);
-			break;
-		case newFigureArc:
-			cairo_new_sub_path(cr);
-			// fall through
-		case arcTo:
-			arc = cairo_arc;
-			if (piece->b)
-				arc = cairo_arc_negative;
-			(*arc)(cr,
-				piece->d[0],
-				piece->d[1],
-				piece->d[2],
-				piece->d[3],
-				piece->d[3] + piece->d[4]);
-			break;
-		case lineTo:
-			cairo_line_to(cr, piece->d[0], piece->d[1]);
-			break;
-		case bezierTo:
-			cairo_curve_to(cr,
-				piece->d[0],
-				piece->d[1],
-				piece->d[2],
-				piece->d[3],
-				piece->d[4],
-				piece->d[5]);
-			break;
-		case closeFigure:
-			cairo_close_path(cr);
-			break;
-		case addRect:
-			cairo_rectangle(cr,
-				piece->d[0],
-				piece->d[1],
-				piece->d[2],
-				piece->d[3]);
-			break;
-		}
-	}
+	if (p->single)
+		runPath(float)
+	else
+		runPath(double)
 }
 
 uiDrawFillMode uiprivPathFillMode(uiDrawPath *path)
@@ -3,27 +3,38 @@
 #include "draw.h"
 #include "attrstr.h"
 
+struct lineInfo {
+	PangoLayoutLine *line;		// owned by layout
+	size_t start;
+	size_t end;
+	uiDrawTextLayoutLineMetrics m;
+};
+
 struct uiDrawTextLayout {
 	PangoLayout *layout;
+	// built on demand by buildLineIndex(); the layout never changes after creation, so neither does this
+	int nLines;
+	struct lineInfo *lines;
 };
 
-// we need a context for a few things
-// the documentation suggests creating cairo_t-specific, GdkScreen-specific, or even GtkWidget-specific contexts, but we can't really do that because we want our uiDrawTextFonts and uiDrawTextLayouts to be context-independent
-// we could use pango_font_map_create_context(pango_cairo_font_map_get_default()) but that will ignore GDK-specific settings
-// so let's use gdk_pango_context_get() instead; even though it's for the default screen only, it's good enough for us
-#define mkGenericPangoCairoContext() (gdk_pango_context_get())
-
 static const PangoAlignment pangoAligns[] = {
 	[uiDrawTextAlignLeft] = PANGO_ALIGN_LEFT,
 	[uiDrawTextAlignCenter] = PANGO_ALIGN_CENTER,
 	[uiDrawTextAlignRight] = PANGO_ALIGN_RIGHT,
 };
 
+// see attrstr.h
+PangoContext *uiprivMkGenericPangoCairoContext(void)
+{
+	if (gdk_display_get_default() == NULL)
+		return pango_font_map_create_context(pango_cairo_font_map_get_default());
+	return gdk_pango_context_get();
+}
+
 uiDrawTextLayout *uiDrawNewTextLayout(uiDrawTextLayoutParams *p)
 {
 	uiDrawTextLayout *tl;
 	PangoContext *context;
-	PangoFontDescription *desc;
 	PangoAttrList *attrs;
 	int pangoWidth;
 
@@ -31,17 +42,16 @@ uiDrawTextLayout *uiDrawNewTextLayout(uiDrawTextLayoutParams *p)
 
 	// in this case, the context is necessary to create the layout
 	// the layout takes a ref on the context so we can unref it afterward
-	context = mkGenericPangoCairoContext();
+	context = uiprivMkGenericPangoCairoContext();
 	tl->layout = pango_layout_new(context);
 	g_object_unref(context);
 
 	// this is safe; pango_layout_set_text() copies the string
 	pango_layout_set_text(tl->layout, uiAttributedStringString(p->String), -1);
 
-	desc = uiprivFontDescriptorToPangoFontDescription(p->DefaultFont);
-	pango_layout_set_font_description(tl->layout, desc);
 	// this is safe; the description is copied
-	pango_font_description_free(desc);
+	pango_layout_set_font_description(tl->layout,
+		uiprivCachedPangoFontDescription(p->DefaultFont));
 
 	pangoWidth = cairoToPango(p->Width);
 	if (p->Width < 0)
@@ -57,8 +67,148 @@ uiDrawTextLayout *uiDrawNewTextLayout(uiDrawTextLayoutParams *p)
 	return tl;
 }
 
+// The async path takes everything it needs from the uiDrawTextLayoutParams on the main thread (including converting the attributes, which touches libui objects), and then builds and shapes the PangoLayout on a worker thread.
+// Pango objects are not thread-safe, so each task gets a PangoContext on a font map of its own instead of the shared GDK one; the settings GDK would have applied to that context are copied over by hand.
+// The font map can't be shared with later tasks on the same thread either: the finished layout is drawn on the main thread, and drawing it goes through the font map's font caches while the next task would be filling them.
+// The font map stays alive for as long as the layout does, because the layout holds a reference to the context, which holds a reference to the font map.
+struct uiDrawTextLayoutTask {
+	uiDrawTextLayoutTaskFunc f;
+	void *data;
+	gint canceled;
+
+	char *text;
+	PangoFontDescription *desc;
+	PangoAttrList *attrs;
+	int pangoWidth;
+	PangoAlignment align;
+	double resolution;
+	cairo_font_options_t *fontOptions;
+
+	PangoLayout *layout;
+};
+
+static GThreadPool *layoutPool = NULL;
+
+// set by uiprivUninitDrawText() so queued tasks only clean up after themselves; nothing would ever deliver them
+static gint shuttingDown = 0;
+
+static gboolean deliverTask(gpointer data)
+{
+	uiDrawTextLayoutTask *task = (uiDrawTextLayoutTask *) data;
+	uiDrawTextLayout *tl;
+
+	if (!g_atomic_int_get(&(task->canceled))) {
+		tl = uiprivNew(uiDrawTextLayout);
+		tl->layout = task->layout;
+		(*(task->f))(task, tl, task->data);
+	} else if (task->layout != NULL)
+		g_object_unref(task->layout);
+	g_free(task);
+	return FALSE;
+}
+
+static void runTask(gpointer data, gpointer unused)
+{
+	uiDrawTextLayoutTask *task = (uiDrawTextLayoutTask *) data;
+	PangoFontMap *fontmap;
+	PangoContext *context;
+
+	if (!g_atomic_int_get(&(task->canceled)) && !g_atomic_int_get(&shuttingDown)) {
+		fontmap = pango_cairo_font_map_new();
+		context = pango_font_map_create_context(fontmap);
+		g_object_unref(fontmap);
+		pango_cairo_context_set_resolution(context, task->resolution);
+		pango_cairo_context_set_font_options(context, task->fontOptions);
+		task->layout = pango_layout_new(context);
+		g_object_unref(context);
+
+		pango_layout_set_text(task->layout, task->text, -1);
+		pango_layout_set_font_description(task->layout, task->desc);
+		pango_layout_set_width(task->layout, task->pangoWidth);
+		pango_layout_set_alignment(task->layout, task->align);
+		pango_layout_set_attributes(task->layout, task->attrs);
+		// this is what actually does the shaping and wrapping
+		pango_layout_get_extents(task->layout, NULL, NULL);
+	}
+
+	// these are only ever touched by this thread after the task is queued, so release them here to keep the main thread's share of the work small
+	g_free(task->text);
+	pango_font_description_free(task->desc);
+	pango_attr_list_unref(task->attrs);
+	cairo_font_options_destroy(task->fontOptions);
+	if (g_atomic_int_get(&shuttingDown)) {
+		if (task->layout != NULL)
+			g_object_unref(task->layout);
+		g_free(task);
+		return;
+	}
+	gdk_threads_add_idle(deliverTask, task);
+}
+
+uiDrawTextLayoutTask *uiDrawNewTextLayoutAsync(uiDrawTextLayoutParams *p, uiDrawTextLayoutTaskFunc f, void *data)
+{
+	uiDrawTextLayoutTask *task;
+	GdkScreen *screen;
+	const cairo_font_options_t *options;
+	GError *err = NULL;
+
+	if (layoutPool == NULL) {
+		layoutPool = g_thread_pool_new(runTask, NULL, g_get_num_processors(), FALSE, &err);
+		if (layoutPool == NULL)
+			uiprivImplBug("error creating text layout thread pool: %s", err->message);
+	}
+
+	// like uiQueueMain(), use g_new0() instead of uiprivNew(); a task that is still pending when uiUninit() is called is never delivered, and that isn't a leak on the user's part
+	task = g_new0(uiDrawTextLayoutTask, 1);
+	task->f = f;
+	task->data = data;
+	task->text = g_strdup(uiAttributedStringString(p->String));
+	task->desc = pango_font_description_copy(uiprivCachedPangoFontDescription(p->DefaultFont));
+	task->attrs = uiprivAttributedStringToPangoAttrList(p);
+	task->pangoWidth = cairoToPango(p->Width);
+	if (p->Width < 0)
+		task->pangoWidth = -1;
+	task->align = pangoAligns[p->Align];
+
+	// these are the settings gdk_pango_context_get() would have given us
+	// without a display, use Pango's defaults like uiprivMkGenericPangoCairoContext() does
+	screen = gdk_screen_get_default();
+	task->resolution = -1;
+	options = NULL;
+	if (screen != NULL) {
+		task->resolution = gdk_screen_get_resolution(screen);
+		options = gdk_screen_get_font_options(screen);
+	}
+	if (options != NULL)
+		task->fontOptions = cairo_font_options_copy(options);
+	else
+		task->fontOptions = cairo_font_options_create();
+
+	g_thread_pool_push(layoutPool, task, NULL);
+	return task;
+}
+
+void uiDrawTextLayoutTaskCancel(uiDrawTextLayoutTask *task)
+{
+	// the task is freed by deliverTask() on the main thread either way
+	g_atomic_int_set(&(task->canceled), 1);
+}
+
+void uiprivUninitDrawText(void)
+{
+	if (layoutPool == NULL)
+		return;
+	// let every queued task run so it frees what it copied, but without doing any layout, and wait for all of them
+	g_atomic_int_set(&shuttingDown, 1);
+	g_thread_pool_free(layoutPool, FALSE, TRUE);
+	layoutPool = NULL;
+	g_atomic_int_set(&shuttingDown, 0);
+}
+
 void uiDrawFreeTextLayout(uiDrawTextLayout *tl)
 {
+	if (tl->lines != NULL)
+		uiprivFree(tl->lines);
 	g_object_unref(tl->layout);
 	uiprivFree(tl);
 }
@@ -79,3 +229,183 @@ void uiDrawTextLayoutExtents(uiDrawTextLayout *tl, double *width, double *height
 	*width = pangoToCairo(logical.width);
 	*height = pangoToCairo(logical.height);
 }
+
+// this is the only part of the line functions that is linear in the number of lines; everything else binary searches the result
+static void buildLineIndex(uiDrawTextLayout *tl)
+{
+	PangoLayoutIter *iter;
+	PangoRectangle logical;
+	struct lineInfo *li;
+	int baselineY;
+
+	if (tl->lines != NULL)
+		return;
+	tl->nLines = pango_layout_get_line_count(tl->layout);
+	tl->lines = (struct lineInfo *) uiprivAlloc(tl->nLines * sizeof (struct lineInfo), "struct lineInfo[] (uiDrawTextLayout)");
+	iter = pango_layout_get_iter(tl->layout);
+	li = tl->lines;
+	do {
+		li->line = pango_layout_iter_get_line_readonly(iter);
+		li->start = li->line->start_index;
+		li->end = li->start + li->line->length;
+		// we use this instead of _get_yrange() because of the block of text in that function's description about how line spacing is distributed in Pango
+		baselineY = pango_layout_iter_get_baseline(iter);
+		pango_layout_iter_get_line_extents(iter, NULL, &logical);
+		li->m.X = pangoToCairo(logical.x);
+		li->m.Y = pangoToCairo(logical.y);
+		li->m.Width = pangoToCairo(logical.width);
+		li->m.Height = pangoToCairo(logical.height);
+		li->m.BaselineY = pangoToCairo(baselineY);
+		li->m.Ascent = pangoToCairo(baselineY - logical.y);
+		li->m.Descent = pangoToCairo(logical.y + logical.height - baselineY);
+		li++;
+	} while (pango_layout_iter_next_line(iter));
+	pango_layout_iter_free(iter);
+	// the last line of a layout has no paragraph separator, so make sure it reaches the end of the text
+	tl->lines[tl->nLines - 1].end = strlen(pango_layout_get_text(tl->layout));
+}
+
+static void checkLine(uiDrawTextLayout *tl, int line, const char *func)
+{
+	if (line < 0 || line >= tl->nLines)
+		uiprivUserBug("Invalid line %d passed to %s(); tl has %d lines.", line, func, tl->nLines);
+}
+
+int uiDrawTextLayoutNumLines(uiDrawTextLayout *tl)
+{
+	buildLineIndex(tl);
+	return tl->nLines;
+}
+
+void uiDrawTextLayoutLineByteRange(uiDrawTextLayout *tl, int line, size_t *start, size_t *end)
+{
+	buildLineIndex(tl);
+	checkLine(tl, line, "uiDrawTextLayoutLineByteRange");
+	*start = tl->lines[line].start;
+	*end = tl->lines[line].end;
+}
+
+void uiDrawTextLayoutLineGetMetrics(uiDrawTextLayout *tl, int line, uiDrawTextLayoutLineMetrics *m)
+{
+	buildLineIndex(tl);
+	checkLine(tl, line, "uiDrawTextLayoutLineGetMetrics");
+	*m = tl->lines[line].m;
+}
+
+int uiDrawTextLayoutLineForByte(uiDrawTextLayout *tl, size_t pos)
+{
+	int lo, hi, mid;
+
+	buildLineIndex(tl);
+	// find the last line that starts at or before pos
+	lo = 0;
+	hi = tl->nLines - 1;
+	while (lo < hi) {
+		mid = lo + (hi - lo + 1) / 2;
+		if (tl->lines[mid].start <= pos)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	return lo;
+}
+
+static int lineForY(uiDrawTextLayout *tl, double y)
+{
+	int lo, hi, mid;
+
+	// find the first line whose bottom is below y; points past the last line go to the last line
+	lo = 0;
+	hi = tl->nLines - 1;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (y < tl->lines[mid].m.Y + tl->lines[mid].m.Height)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo;
+}
+
+// note: Pango will not let us place the cursor at the end of a line the same way other OSs do; see https://git.gnome.org/browse/pango/tree/pango/pango-layout.c?id=f4cbd27f4e5bf8490ea411190d41813e14f12165#n4204
+// ideally there'd be a way to say "I don't need this hack; I'm well behaved" but GTK+ 2 and 3 AND Qt 4 and 5 all behave like this, with the behavior seeming to date back to TkTextView, so...
+void uiDrawTextLayoutHitTest(uiDrawTextLayout *tl, double x, double y, size_t *pos, int *line)
+{
+	struct lineInfo *li;
+	const char *text;
+	int index, trailing;
+
+	buildLineIndex(tl);
+	*line = lineForY(tl, y);
+	li = &(tl->lines[*line]);
+	// unlike pango_layout_xy_to_index(), this doesn't walk every line before the one we want
+	// x is relative to the left edge of the line, which depends on the alignment
+	pango_layout_line_x_to_index(li->line,
+		cairoToPango(x - li->m.X),
+		&index, &trailing);
+	// on a trailing hit, trailing is the number of characters to move forward to reach the end of the grapheme
+	text = pango_layout_get_text(tl->layout);
+	*pos = g_utf8_offset_to_pointer(text + index, trailing) - text;
+}
+
+double uiDrawTextLayoutByteLocationInLine(uiDrawTextLayout *tl, size_t pos, int line)
+{
+	struct lineInfo *li;
+	gboolean trailing;
+	int pangox;
+
+	buildLineIndex(tl);
+	if (line < 0 || line >= tl->nLines)
+		return -1;
+	li = &(tl->lines[line]);
+	// note: >, not >=, because the position at end is valid!
+	if (pos < li->start || pos > li->end)
+		return -1;
+	// pango_layout_line_index_to_x() can't take the position after the last grapheme directly; ask for the trailing edge of the grapheme before it instead
+	trailing = FALSE;
+	if (pos != li->start && pos == li->end) {
+		pos = g_utf8_prev_char(pango_layout_get_text(tl->layout) + pos) - pango_layout_get_text(tl->layout);
+		trailing = TRUE;
+	}
+	pango_layout_line_index_to_x(li->line, pos, trailing, &pangox);
+	return li->m.X + pangoToCairo(pangox);
+}
+
+void uiDrawTextLayoutForEachRangeRect(uiDrawTextLayout *tl, size_t start, size_t end, uiDrawTextLayoutRangeRectFunc f, void *data)
+{
+	struct lineInfo *li;
+	int first, last;
+	int *ranges;
+	int i, j, n;
+	size_t lstart, lend;
+	uiForEach ret;
+
+	if (start >= end)
+		return;
+	buildLineIndex(tl);
+	first = uiDrawTextLayoutLineForByte(tl, start);
+	last = uiDrawTextLayoutLineForByte(tl, end - 1);
+	for (i = first; i <= last; i++) {
+		li = &(tl->lines[i]);
+		lstart = start;
+		if (lstart < li->start)
+			lstart = li->start;
+		lend = end;
+		if (lend > li->end)
+			lend = li->end;
+		// the x ranges are already relative to the layout, not the line
+		pango_layout_line_get_x_ranges(li->line, lstart, lend, &ranges, &n);
+		ret = uiForEachContinue;
+		for (j = 0; j < n; j++) {
+			ret = (*f)(tl,
+				pangoToCairo(ranges[2 * j]), li->m.Y,
+				pangoToCairo(ranges[2 * j + 1] - ranges[2 * j]), li->m.Height,
+				data);
+			if (ret == uiForEachStop)
+				break;
+		}
+		g_free(ranges);
+		if (ret == uiForEachStop)
+			return;
+	}
+}
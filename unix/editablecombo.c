@@ -10,6 +10,8 @@ struct uiEditableCombobox {
 	void (*onChanged)(uiEditableCombobox *, void *);
 	void *onChangedData;
 	gulong onChangedSignal;
+	const char *(*item)(uiEditableCombobox *, int, void *);
+	void *itemData;
 };
 
 uiUnixControlAllDefaults(uiEditableCombobox)
@@ -28,9 +30,30 @@ static void defaultOnChanged(uiEditableCombobox *c, void *data)
 
 void uiEditableComboboxAppend(uiEditableCombobox *c, const char *text)
 {
+	if (uiprivComboBoxIsVirtual(c->combobox))
+		uiprivUserBug("You cannot call uiEditableComboboxAppend() on a uiEditableCombobox with virtual items. (combobox: %p)", c);
 	gtk_combo_box_text_append(c->comboboxText, NULL, text);
 }
 
+void uiEditableComboboxSetItems(uiEditableCombobox *c, const char *const *items, int n)
+{
+	uiprivComboBoxSetModel(c->combobox, uiprivNewComboListModel(items, n), c->onChangedSignal);
+}
+
+static const char *virtualItem(gpointer owner, int i)
+{
+	uiEditableCombobox *c = uiEditableCombobox(owner);
+
+	return (*(c->item))(c, i, c->itemData);
+}
+
+void uiEditableComboboxSetVirtualItems(uiEditableCombobox *c, int n, const char *(*item)(uiEditableCombobox *c, int i, void *data), void *data)
+{
+	c->item = item;
+	c->itemData = data;
+	uiprivComboBoxSetVirtualModel(c->combobox, uiprivNewComboVirtualModel(n, virtualItem, c), c->onChangedSignal);
+}
+
 char *uiEditableComboboxText(uiEditableCombobox *c)
 {
 	char *s;
@@ -9,14 +9,31 @@ struct uiEntry {
 	void (*onChanged)(uiEntry *, void *);
 	void *onChangedData;
 	gulong onChangedSignal;
+	uiprivThrottle *throttle;
 };
 
-uiUnixControlAllDefaults(uiEntry)
+uiUnixControlAllDefaultsExceptDestroy(uiEntry)
+
+static void uiEntryDestroy(uiControl *c)
+{
+	uiEntry *e = uiEntry(c);
+
+	uiprivFreeThrottle(e->throttle);
+	g_object_unref(e->widget);
+	uiFreeControl(uiControl(e));
+}
 
 static void onChanged(GtkEditable *editable, gpointer data)
 {
 	uiEntry *e = uiEntry(data);
 
+	uiprivThrottleNotify(e->throttle);
+}
+
+static void fireChanged(void *data)
+{
+	uiEntry *e = uiEntry(data);
+
 	(*(e->onChanged))(e, e->onChangedData);
 }
 
@@ -45,6 +62,11 @@ void uiEntryOnChanged(uiEntry *e, void (*f)(uiEntry *, void *), void *data)
 	e->onChangedData = data;
 }
 
+void uiEntrySetChangePolicy(uiEntry *e, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(e->throttle, policy, milliseconds);
+}
+
 int uiEntryReadOnly(uiEntry *e)
 {
 	return gtk_editable_get_editable(e->editable) == FALSE;
@@ -70,6 +92,7 @@ static uiEntry *finishNewEntry(GtkWidget *w, const gchar *signal)
 	e->entry = GTK_ENTRY(e->widget);
 	e->editable = GTK_EDITABLE(e->widget);
 
+	e->throttle = uiprivNewThrottle(fireChanged, e);
 	e->onChangedSignal = g_signal_connect(e->widget, signal, G_CALLBACK(onChanged), e);
 	uiEntryOnChanged(e, defaultOnChanged, NULL);
 
@@ -54,6 +54,90 @@ PangoFontDescription *uiprivFontDescriptorToPangoFontDescription(const uiFontDes
 	return desc;
 }
 
+// text layouts are usually created over and over with the same handful of default fonts, so keep the converted descriptions around
+// the cache is emptied if it ever gets big; that only happens if a program goes through lots of different fonts, in which case the cache wouldn't help much anyway
+#define maxCachedDescs 64
+
+struct descKey {
+	char *family;
+	double size;
+	uiTextWeight weight;
+	uiTextItalic italic;
+	uiTextStretch stretch;
+};
+
+static GHashTable *descCache = NULL;
+
+static guint descKeyHash(gconstpointer k)
+{
+	const struct descKey *key = (const struct descKey *) k;
+	guint h;
+
+	h = g_str_hash(key->family);
+	h = h * 31 + g_double_hash(&(key->size));
+	h = h * 31 + (guint) (key->weight);
+	h = h * 31 + (guint) (key->italic);
+	h = h * 31 + (guint) (key->stretch);
+	return h;
+}
+
+static gboolean descKeyEqual(gconstpointer ka, gconstpointer kb)
+{
+	const struct descKey *a = (const struct descKey *) ka;
+	const struct descKey *b = (const struct descKey *) kb;
+
+	return strcmp(a->family, b->family) == 0 &&
+		a->size == b->size &&
+		a->weight == b->weight &&
+		a->italic == b->italic &&
+		a->stretch == b->stretch;
+}
+
+static void freeDescKey(gpointer k)
+{
+	struct descKey *key = (struct descKey *) k;
+
+	g_free(key->family);
+	g_free(key);
+}
+
+// the returned description is owned by the cache and only valid until the next call
+const PangoFontDescription *uiprivCachedPangoFontDescription(const uiFontDescriptor *uidesc)
+{
+	struct descKey key;
+	struct descKey *newKey;
+	PangoFontDescription *desc;
+
+	if (descCache == NULL)
+		descCache = g_hash_table_new_full(descKeyHash, descKeyEqual,
+			freeDescKey, (GDestroyNotify) pango_font_description_free);
+	key.family = uidesc->Family;
+	key.size = uidesc->Size;
+	key.weight = uidesc->Weight;
+	key.italic = uidesc->Italic;
+	key.stretch = uidesc->Stretch;
+	desc = (PangoFontDescription *) g_hash_table_lookup(descCache, &key);
+	if (desc != NULL)
+		return desc;
+
+	if (g_hash_table_size(descCache) >= maxCachedDescs)
+		g_hash_table_remove_all(descCache);
+	newKey = g_new(struct descKey, 1);
+	*newKey = key;
+	newKey->family = g_strdup(key.family);
+	desc = uiprivFontDescriptorToPangoFontDescription(uidesc);
+	g_hash_table_insert(descCache, newKey, desc);
+	return desc;
+}
+
+void uiprivUninitFontMatch(void)
+{
+	if (descCache == NULL)
+		return;
+	g_hash_table_destroy(descCache);
+	descCache = NULL;
+}
+
 void uiprivFontDescriptorFromPangoFontDescription(PangoFontDescription *pdesc, uiFontDescriptor *uidesc)
 {
 	PangoStyle pitalic;
@@ -1,20 +1,56 @@
 // 27 june 2016
 #include "uipriv_unix.h"
+#include "draw.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// how many target sizes uiDrawImage() remembers per image; a view usually draws an image at one or two sizes at a time
+#define nSizeCache 4
+
+struct sizeCache {
+	int targetX;
+	int targetY;
+	cairo_surface_t *surface;		// not a reference; owned by one of the representations
+};
 
 struct uiImage {
 	double width;
 	double height;
 	GPtrArray *images;
+
+	// for uiprivImageAppropriateSurface()
+	int lastScale;
+	cairo_surface_t *lastMatch;
+
+	// for uiDrawImage(); most recently used first
+	struct sizeCache sizes[nSizeCache];
+	int nSizes;
 };
 
-static void freeImageRep(gpointer item)
+// each representation is a cairo image surface whose pixel buffer is released by the surface's user data when the surface is destroyed
+// this way, the buffer lives exactly as long as the surface, even if something else (like a GtkCellRenderer) still holds a reference after uiFreeImage()
+// that can be after uiUninit() too, so none of these buffers come from uiprivAlloc()
+static const cairo_user_data_key_t pixelsKey;
+
+struct borrowed {
+	void *pixels;
+	void (*destroy)(void *pixels, void *data);
+	void *data;
+};
+
+static void freeBorrowedPixels(void *data)
 {
-	cairo_surface_t *cs = (cairo_surface_t *) item;
-	unsigned char *buf;
+	struct borrowed *b = (struct borrowed *) data;
 
-	buf = cairo_image_surface_get_data(cs);
-	cairo_surface_destroy(cs);
-	uiprivFree(buf);
+	if (b->destroy != NULL)
+		(*(b->destroy))(b->pixels, b->data);
+	g_free(b);
+}
+
+static void freeImageRep(gpointer item)
+{
+	cairo_surface_destroy((cairo_surface_t *) item);
 }
 
 uiImage *uiNewImage(double width, double height)
@@ -34,30 +70,144 @@ void uiFreeImage(uiImage *i)
 	uiprivFree(i);
 }
 
-void uiImageAppend(uiImage *i, void *pixels, int pixelWidth, int pixelHeight, int byteStride)
+int uiImagePreferredByteStride(int pixelWidth)
+{
+	return cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, pixelWidth);
+}
+
+static void appendSurface(uiImage *i, unsigned char *buf, int pixelWidth, int pixelHeight, int byteStride, void *userData, cairo_destroy_func_t freeUserData)
 {
 	cairo_surface_t *cs;
-	unsigned char *buf, *p;
-	uint8_t *src = (uint8_t *) pixels;
-	int cByteStride;
-	int n;
 
-	// unfortunately for optimal performance cairo expects its own stride values and we will have to reconcile them if they differ
-	cByteStride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, pixelWidth);
-	buf = (unsigned char *) uiprivAlloc((cByteStride * pixelHeight) * sizeof (unsigned char), "unsigned char[]");
-	p = buf;
-	for (n = 0; n < byteStride * pixelHeight; n += byteStride) {
-		memmove(p, src + n, cByteStride);
-		p += cByteStride;
-	}
 	// also note that stride here is also in bytes
 	cs = cairo_image_surface_create_for_data(buf, CAIRO_FORMAT_ARGB32,
 		pixelWidth, pixelHeight,
-		cByteStride);
+		byteStride);
 	if (cairo_surface_status(cs) != CAIRO_STATUS_SUCCESS)
 		/* TODO */;
+	cairo_surface_set_user_data(cs, &pixelsKey, userData, freeUserData);
 	cairo_surface_flush(cs);
 	g_ptr_array_add(i->images, cs);
+	// the best match may be different now
+	i->lastMatch = NULL;
+	i->nSizes = 0;
+}
+
+// freed with g_free(); see above
+static unsigned char *newPixels(int cByteStride, int pixelHeight)
+{
+	return (unsigned char *) g_malloc0((cByteStride * pixelHeight) * sizeof (unsigned char));
+}
+
+// this is the (x + 128) / 255 rounding trick from Jim Blinn; it is exact for all products of two bytes
+#define div255(x) ((((x) + 128) + (((x) + 128) >> 8)) >> 8)
+
+#if defined(__SSE2__) && G_BYTE_ORDER == G_LITTLE_ENDIAN
+// converts two pixels, unpacked to 16 bits per channel as [R G B A R G B A]
+static __m128i premultiplyTwo(__m128i v)
+{
+	const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+	const __m128i alpha255 = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+	const __m128i c128 = _mm_set1_epi16(128);
+	__m128i a;
+
+	// swap R and B to get cairo's [B G R A] (0xAARRGGBB in little-endian)
+	v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 0, 1, 2));
+	v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(3, 0, 1, 2));
+	// multiply every channel by alpha except alpha itself, which gets multiplied by 255 to come back out of div255() unchanged
+	a = _mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3));
+	a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+	a = _mm_or_si128(_mm_andnot_si128(alphaLanes, a), alpha255);
+	v = _mm_mullo_epi16(v, a);
+	// and div255()
+	v = _mm_add_epi16(v, c128);
+	v = _mm_add_epi16(v, _mm_srli_epi16(v, 8));
+	return _mm_srli_epi16(v, 8);
+}
+#endif
+
+// converts n non-premultiplied [R G B A] pixels to premultiplied native-endian 0xAARRGGBB
+static void premultiplyRow(uint32_t *dst, const uint8_t *src, int n)
+{
+	int x = 0;
+	uint32_t r, g, b, a;
+
+#if defined(__SSE2__) && G_BYTE_ORDER == G_LITTLE_ENDIAN
+	const __m128i zero = _mm_setzero_si128();
+	__m128i px, lo, hi;
+
+	for (; x + 4 <= n; x += 4) {
+		px = _mm_loadu_si128((const __m128i *) (src + 4 * x));
+		lo = premultiplyTwo(_mm_unpacklo_epi8(px, zero));
+		hi = premultiplyTwo(_mm_unpackhi_epi8(px, zero));
+		_mm_storeu_si128((__m128i *) (dst + x), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	for (; x < n; x++) {
+		r = src[4 * x];
+		g = src[4 * x + 1];
+		b = src[4 * x + 2];
+		a = src[4 * x + 3];
+		dst[x] = (a << 24) |
+			(div255(r * a) << 16) |
+			(div255(g * a) << 8) |
+			div255(b * a);
+	}
+}
+
+void uiImageAppend(uiImage *i, void *pixels, int pixelWidth, int pixelHeight, int byteStride)
+{
+	unsigned char *buf;
+	uint8_t *src = (uint8_t *) pixels;
+	int cByteStride;
+	int y;
+
+	// unfortunately for optimal performance cairo expects its own stride values and we will have to reconcile them if they differ
+	// we have to convert each row anyway, so this costs nothing extra
+	cByteStride = uiImagePreferredByteStride(pixelWidth);
+	buf = newPixels(cByteStride, pixelHeight);
+	for (y = 0; y < pixelHeight; y++)
+		premultiplyRow((uint32_t *) (buf + y * cByteStride),
+			src + y * byteStride,
+			pixelWidth);
+	appendSurface(i, buf, pixelWidth, pixelHeight, cByteStride, buf, g_free);
+}
+
+void uiImageAppendPremultiplied(uiImage *i, void *pixels, int pixelWidth, int pixelHeight, int byteStride)
+{
+	unsigned char *buf;
+	uint8_t *src = (uint8_t *) pixels;
+	int cByteStride;
+	int y;
+
+	cByteStride = uiImagePreferredByteStride(pixelWidth);
+	buf = newPixels(cByteStride, pixelHeight);
+	if (byteStride == cByteStride)
+		memcpy(buf, src, cByteStride * pixelHeight);
+	else
+		for (y = 0; y < pixelHeight; y++)
+			memcpy(buf + y * cByteStride,
+				src + y * byteStride,
+				pixelWidth * 4);
+	appendSurface(i, buf, pixelWidth, pixelHeight, cByteStride, buf, g_free);
+}
+
+void uiImageAppendBorrowed(uiImage *i, void *pixels, int pixelWidth, int pixelHeight, int byteStride, void (*destroy)(void *pixels, void *data), void *data)
+{
+	struct borrowed *b;
+
+	// cairo can use any stride it would have picked itself, provided the buffer is aligned the same way its own would be
+	if (byteStride != uiImagePreferredByteStride(pixelWidth) || (((uintptr_t) pixels) % sizeof (uint32_t)) != 0) {
+		uiImageAppendPremultiplied(i, pixels, pixelWidth, pixelHeight, byteStride);
+		if (destroy != NULL)
+			(*destroy)(pixels, data);
+		return;
+	}
+	b = g_new0(struct borrowed, 1);
+	b->pixels = pixels;
+	b->destroy = destroy;
+	b->data = data;
+	appendSurface(i, (unsigned char *) pixels, pixelWidth, pixelHeight, byteStride, b, freeBorrowedPixels);
 }
 
 struct matcher {
@@ -107,16 +257,176 @@ writeMatch:
 	m->distY = abs(m->targetY - y);
 }
 
-cairo_surface_t *uiprivImageAppropriateSurface(uiImage *i, GtkWidget *w)
+static cairo_surface_t *bestRep(uiImage *i, int targetX, int targetY)
 {
 	struct matcher m;
 
 	m.best = NULL;
 	m.distX = G_MAXINT;
 	m.distY = G_MAXINT;
-	m.targetX = i->width * gtk_widget_get_scale_factor(w);
-	m.targetY = i->height * gtk_widget_get_scale_factor(w);
+	m.targetX = targetX;
+	m.targetY = targetY;
 	m.foundLarger = FALSE;
 	g_ptr_array_foreach(i->images, match, &m);
 	return m.best;
 }
+
+// this is called for every cell of every uiTable image column on every redraw, so remember the last answer
+cairo_surface_t *uiprivImageAppropriateSurface(uiImage *i, GtkWidget *w)
+{
+	int scale;
+
+	scale = gtk_widget_get_scale_factor(w);
+	if (i->lastMatch == NULL || i->lastScale != scale) {
+		i->lastMatch = bestRep(i, i->width * scale, i->height * scale);
+		i->lastScale = scale;
+	}
+	return i->lastMatch;
+}
+
+// Mip levels are made by repeatedly halving a representation, and are kept in the representation's user data so they live and die with it.
+// Level 0 is the representation itself.
+static const cairo_user_data_key_t mipsKey;
+
+struct mips {
+	int n;
+	cairo_surface_t *levels[32];
+};
+
+static void freeMips(void *data)
+{
+	struct mips *m = (struct mips *) data;
+	int i;
+
+	// don't destroy level 0; that's the surface this is attached to
+	for (i = 1; i < m->n; i++)
+		cairo_surface_destroy(m->levels[i]);
+	g_free(m);
+}
+
+static cairo_surface_t *halve(cairo_surface_t *src)
+{
+	cairo_surface_t *dst;
+	cairo_t *cr;
+	int sw, sh, dw, dh;
+
+	sw = cairo_image_surface_get_width(src);
+	sh = cairo_image_surface_get_height(src);
+	dw = (sw + 1) / 2;
+	dh = (sh + 1) / 2;
+	dst = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, dw, dh);
+	cr = cairo_create(dst);
+	cairo_scale(cr, ((double) dw) / sw, ((double) dh) / sh);
+	cairo_set_source_surface(cr, src, 0, 0);
+	// GOOD uses a box filter when downscaling, which is what we want for a mip level
+	cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+	cairo_pattern_set_extend(cairo_get_source(cr), CAIRO_EXTEND_PAD);
+	cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+	cairo_paint(cr);
+	cairo_destroy(cr);
+	return dst;
+}
+
+// returns the smallest mip level of rep that is still at least as big as the target, generating levels as needed
+static cairo_surface_t *mipFor(cairo_surface_t *rep, int targetX, int targetY)
+{
+	struct mips *m;
+	cairo_surface_t *level;
+	int j;
+
+	m = (struct mips *) cairo_surface_get_user_data(rep, &mipsKey);
+	if (m == NULL) {
+		m = g_new0(struct mips, 1);
+		m->levels[0] = rep;
+		m->n = 1;
+		cairo_surface_set_user_data(rep, &mipsKey, m, freeMips);
+	}
+	for (j = 0; ; j++) {
+		level = m->levels[j];
+		if (cairo_image_surface_get_width(level) / 2 < targetX || cairo_image_surface_get_height(level) / 2 < targetY)
+			break;
+		if (j + 1 == G_N_ELEMENTS(m->levels))
+			break;
+		if (j + 1 == m->n) {
+			m->levels[m->n] = halve(level);
+			m->n++;
+		}
+	}
+	return level;
+}
+
+static cairo_surface_t *surfaceForSize(uiImage *i, int targetX, int targetY)
+{
+	struct sizeCache found;
+	int j;
+
+	for (j = 0; j < i->nSizes; j++)
+		if (i->sizes[j].targetX == targetX && i->sizes[j].targetY == targetY)
+			break;
+	if (j < i->nSizes)
+		found = i->sizes[j];
+	else {
+		found.targetX = targetX;
+		found.targetY = targetY;
+		found.surface = mipFor(bestRep(i, targetX, targetY), targetX, targetY);
+		// drop the least recently used entry if full
+		if (i->nSizes < nSizeCache)
+			i->nSizes++;
+		j = i->nSizes - 1;
+	}
+	// and move to the front
+	memmove(i->sizes + 1, i->sizes, j * sizeof (struct sizeCache));
+	i->sizes[0] = found;
+	return found.surface;
+}
+
+void uiDrawImage(uiDrawContext *c, uiImage *img, double x, double y, double width, double height, uiDrawImageFilter filter)
+{
+	double cx0, cy0, cx1, cy1;
+	double dx, dy;
+	int targetX, targetY;
+	cairo_surface_t *cs;
+
+	if (img->images->len == 0 || width <= 0 || height <= 0)
+		return;
+	cairo_clip_extents(c->cr, &cx0, &cy0, &cx1, &cy1);
+	if (x >= cx1 || y >= cy1 || x + width <= cx0 || y + height <= cy0)
+		return;
+
+	// figure out how many device pixels the destination covers; this includes both the current transform and the device scale
+	dx = width;
+	dy = height;
+	cairo_user_to_device_distance(c->cr, &dx, &dy);
+	targetX = (int) ceil(fabs(dx));
+	targetY = (int) ceil(fabs(dy));
+	if (targetX < 1)
+		targetX = 1;
+	if (targetY < 1)
+		targetY = 1;
+	if (filter == uiDrawImageFilterNearest)
+		// prescaling would blur the pixels we're trying to show
+		cs = bestRep(img, targetX, targetY);
+	else
+		cs = surfaceForSize(img, targetX, targetY);
+
+	cairo_save(c->cr);
+	cairo_rectangle(c->cr, x, y, width, height);
+	cairo_clip(c->cr);
+	cairo_translate(c->cr, x, y);
+	cairo_scale(c->cr,
+		width / cairo_image_surface_get_width(cs),
+		height / cairo_image_surface_get_height(cs));
+	cairo_set_source_surface(c->cr, cs, 0, 0);
+	switch (filter) {
+	case uiDrawImageFilterNearest:
+		cairo_pattern_set_filter(cairo_get_source(c->cr), CAIRO_FILTER_NEAREST);
+		break;
+	case uiDrawImageFilterLinear:
+		cairo_pattern_set_filter(cairo_get_source(c->cr), CAIRO_FILTER_BILINEAR);
+		break;
+	}
+	// without this, the edges would be blended with transparent black
+	cairo_pattern_set_extend(cairo_get_source(c->cr), CAIRO_EXTEND_PAD);
+	cairo_paint(c->cr);
+	cairo_restore(c->cr);
+}
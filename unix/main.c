@@ -1,24 +1,55 @@
 // 6 april 2015
 #include "uipriv_unix.h"
+#include <errno.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 uiInitOptions uiprivOptions;
 
 static GHashTable *timers;
 
+// for uiMainGetPollFD() and friends; see below
+static gboolean prepared = FALSE;
+static gint maxPriority;
+static GPollFD *pollfds = NULL;
+static gint nPollfds = 0;
+static gint capPollfds = 0;
+// scratch space for syncEpoll(), and what's currently registered with epfd
+static GPollFD *merged = NULL;
+static gint capMerged = 0;
+static GPollFD *registered = NULL;
+static gint nRegistered = 0;
+static gint capRegistered = 0;
+static int epfd = -1;
+
+static void initCommon(uiInitOptions *o)
+{
+	uiprivOptions = *o;
+	uiprivInitAlloc();
+	uiprivLoadFutures();
+	timers = g_hash_table_new(g_direct_hash, g_direct_equal);
+}
+
 const char *uiInit(uiInitOptions *o)
 {
 	GError *err = NULL;
 	const char *msg;
 
-	uiprivOptions = *o;
 	if (gtk_init_with_args(NULL, NULL, NULL, NULL, NULL, &err) == FALSE) {
 		msg = g_strdup(err->message);
 		g_error_free(err);
 		return msg;
 	}
-	uiprivInitAlloc();
-	uiprivLoadFutures();
-	timers = g_hash_table_new(g_direct_hash, g_direct_equal);
+	initCommon(o);
+	return NULL;
+}
+
+// no gtk_init(); everything that needs a GdkDisplay is off-limits, and the parts of libui that can be used without one check gdk_display_get_default() themselves
+const char *uiInitHeadless(uiInitOptions *o)
+{
+	initCommon(o);
 	return NULL;
 }
 
@@ -33,6 +64,32 @@ void uiUninit(void)
 {
 	g_hash_table_foreach(timers, uninitTimer, NULL);
 	g_hash_table_destroy(timers);
+	if (epfd != -1) {
+		close(epfd);
+		epfd = -1;
+	}
+	// and reset everything else, so a later uiInit() starts from scratch instead of reusing freed buffers
+	if (pollfds != NULL)
+		uiprivFree(pollfds);
+	pollfds = NULL;
+	nPollfds = 0;
+	capPollfds = 0;
+	if (merged != NULL)
+		uiprivFree(merged);
+	merged = NULL;
+	capMerged = 0;
+	if (registered != NULL)
+		uiprivFree(registered);
+	registered = NULL;
+	nRegistered = 0;
+	capRegistered = 0;
+	// uiMainPrepare() acquired the context; don't leave it owned by this thread past uiUninit()
+	if (prepared)
+		g_main_context_release(g_main_context_default());
+	prepared = FALSE;
+	uiprivUninitDrawText();
+	uiprivUninitParallel();
+	uiprivUninitFontMatch();
 	uiprivUninitMenus();
 	uiprivUninitAlloc();
 }
@@ -75,6 +132,148 @@ int uiMainStep(int wait)
 	return (*iteration)(block) == FALSE;
 }
 
+// for driving the main loop from someone else's event loop: one iteration of a GMainContext is prepare, query, poll, check, dispatch, and we hand the poll part to the caller
+// GLib wants poll() on a whole set of fds, so we fold that set into an epoll fd the caller can wait on instead; the set can change from one iteration to the next, so uiMainPrepare() syncs it each time
+
+#ifdef __linux__
+static guint32 toEpoll(gushort events)
+{
+	guint32 out = 0;
+
+	if ((events & G_IO_IN) != 0)
+		out |= EPOLLIN;
+	if ((events & G_IO_OUT) != 0)
+		out |= EPOLLOUT;
+	if ((events & G_IO_PRI) != 0)
+		out |= EPOLLPRI;
+	// EPOLLERR and EPOLLHUP are always reported
+	return out;
+}
+
+static void syncEpoll(void)
+{
+	gint i, j, n;
+	struct epoll_event ev;
+
+	// epoll only takes each fd once, so merge the events of duplicate fds
+	// this has to be a separate array; g_main_context_check() matches pollfds to its sources by position
+	if (capMerged < nPollfds) {
+		capMerged = nPollfds;
+		merged = (GPollFD *) uiprivRealloc(merged, capMerged * sizeof (GPollFD), "GPollFD[]");
+	}
+	n = 0;
+	for (i = 0; i < nPollfds; i++) {
+		for (j = 0; j < n; j++)
+			if (merged[j].fd == pollfds[i].fd)
+				break;
+		if (j < n) {
+			merged[j].events |= pollfds[i].events;
+			continue;
+		}
+		merged[n] = pollfds[i];
+		n++;
+	}
+
+	// most of the time nothing changed
+	if (n == nRegistered) {
+		for (i = 0; i < n; i++)
+			if (merged[i].fd != registered[i].fd || merged[i].events != registered[i].events)
+				break;
+		if (i == n)
+			return;
+	}
+
+	for (i = 0; i < nRegistered; i++)
+		// the fd may already be closed, which removes it for us; ignore errors
+		epoll_ctl(epfd, EPOLL_CTL_DEL, registered[i].fd, NULL);
+	if (capRegistered < n) {
+		capRegistered = n;
+		registered = (GPollFD *) uiprivRealloc(registered, capRegistered * sizeof (GPollFD), "GPollFD[]");
+	}
+	for (i = 0; i < n; i++) {
+		memset(&ev, 0, sizeof (struct epoll_event));
+		ev.events = toEpoll(merged[i].events);
+		ev.data.fd = merged[i].fd;
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, merged[i].fd, &ev) == -1)
+			uiprivImplBug("error adding fd %d to epoll fd for uiMainGetPollFD(): %s", merged[i].fd, g_strerror(errno));
+		registered[i] = merged[i];
+	}
+	nRegistered = n;
+}
+#endif
+
+int uiMainGetPollFD(void)
+{
+#ifdef __linux__
+	if (iteration != stepsIteration)
+		uiprivUserBug("You must call uiMainSteps() before calling uiMainGetPollFD().");
+	if (epfd == -1) {
+		epfd = epoll_create1(EPOLL_CLOEXEC);
+		if (epfd == -1)
+			uiprivImplBug("error creating epoll fd for uiMainGetPollFD(): %s", g_strerror(errno));
+		if (prepared)
+			syncEpoll();
+	}
+	return epfd;
+#else
+	// documented in ui.h: the epoll fd is Linux-only
+	return -1;
+#endif
+}
+
+int uiMainPrepare(void)
+{
+	GMainContext *ctx;
+	gint timeout;
+	gint n;
+
+	if (iteration != stepsIteration)
+		uiprivUserBug("You must call uiMainSteps() before calling uiMainPrepare().");
+	if (prepared)
+		uiprivUserBug("You cannot call uiMainPrepare() twice without calling uiMainDispatch() in between.");
+	ctx = g_main_context_default();
+	if (!g_main_context_acquire(ctx))
+		uiprivUserBug("You cannot call uiMainPrepare() while another thread is running the main loop.");
+	g_main_context_prepare(ctx, &maxPriority);
+	for (;;) {
+		n = g_main_context_query(ctx, maxPriority, &timeout, pollfds, capPollfds);
+		if (n <= capPollfds)
+			break;
+		capPollfds = n;
+		pollfds = (GPollFD *) uiprivRealloc(pollfds, capPollfds * sizeof (GPollFD), "GPollFD[]");
+	}
+	nPollfds = n;
+#ifdef __linux__
+	if (epfd != -1)
+		syncEpoll();
+#endif
+	prepared = TRUE;
+	return timeout;
+}
+
+int uiMainDispatch(int budgetMilliseconds)
+{
+	GMainContext *ctx;
+	gint64 deadline;
+
+	if (!prepared)
+		uiprivUserBug("You must call uiMainPrepare() before calling uiMainDispatch().");
+	ctx = g_main_context_default();
+	deadline = g_get_monotonic_time() + ((gint64) budgetMilliseconds) * 1000;
+	// the caller's wait told us something is ready, but not what; GLib needs revents filled in
+	g_poll(pollfds, nPollfds, 0);
+	if (g_main_context_check(ctx, maxPriority, pollfds, nPollfds))
+		g_main_context_dispatch(ctx);
+	g_main_context_release(ctx);
+	prepared = FALSE;
+	// then keep going for as long as there's more to do and the budget lasts
+	// a single source's callback can still run past the deadline; GLib gives us no way to stop it
+	while (!stepsQuit && g_get_monotonic_time() < deadline)
+		if (!g_main_context_iteration(ctx, FALSE))
+			break;
+	return !stepsQuit;
+}
+
 // gtk_main_quit() may run immediately, or it may wait for other pending events; "it depends" (thanks mclasen in irc.gimp.net/#gtk+)
 // PostQuitMessage() on Windows always waits, so we must do so too
 // we'll do it by using an idle callback
@@ -14,14 +14,39 @@ struct uiMultilineEntry {
 	void (*onChanged)(uiMultilineEntry *, void *);
 	void *onChangedData;
 	gulong onChangedSignal;
+	uiprivThrottle *throttle;
+	// text appended since the last frame; see uiMultilineEntryAppend()
+	GString *pending;
+	guint tickCallback;
+	int maxLines;
+	GtkTextMark *endMark;
 };
 
-uiUnixControlAllDefaults(uiMultilineEntry)
+uiUnixControlAllDefaultsExceptDestroy(uiMultilineEntry)
+
+static void uiMultilineEntryDestroy(uiControl *c)
+{
+	uiMultilineEntry *e = uiMultilineEntry(c);
+
+	if (e->tickCallback != 0)
+		gtk_widget_remove_tick_callback(e->textviewWidget, e->tickCallback);
+	g_string_free(e->pending, TRUE);
+	uiprivFreeThrottle(e->throttle);
+	g_object_unref(e->widget);
+	uiFreeControl(uiControl(e));
+}
 
 static void onChanged(GtkTextBuffer *textbuf, gpointer data)
 {
 	uiMultilineEntry *e = uiMultilineEntry(data);
 
+	uiprivThrottleNotify(e->throttle);
+}
+
+static void fireChanged(void *data)
+{
+	uiMultilineEntry *e = uiMultilineEntry(data);
+
 	(*(e->onChanged))(e, e->onChangedData);
 }
 
@@ -30,37 +55,134 @@ static void defaultOnChanged(uiMultilineEntry *e, void *data)
 	// do nothing
 }
 
+// drops lines from the start of the buffer until there are at most e->maxLines, all in one go
+// a trailing newline doesn't count as starting another line
+static void trimLines(uiMultilineEntry *e)
+{
+	GtkTextIter start, cut;
+	gint n;
+
+	if (e->maxLines <= 0)
+		return;
+	n = gtk_text_buffer_get_line_count(e->textbuf);
+	gtk_text_buffer_get_end_iter(e->textbuf, &cut);
+	if (gtk_text_iter_starts_line(&cut) && n > 1)
+		n--;
+	if (n <= e->maxLines)
+		return;
+	gtk_text_buffer_get_start_iter(e->textbuf, &start);
+	gtk_text_buffer_get_iter_at_line(e->textbuf, &cut, n - e->maxLines);
+	gtk_text_buffer_delete(e->textbuf, &start, &cut);
+}
+
+static gboolean atBottom(uiMultilineEntry *e)
+{
+	GtkAdjustment *adj;
+
+	adj = gtk_scrolled_window_get_vadjustment(e->sw);
+	// allow for rounding
+	return gtk_adjustment_get_value(adj) >= gtk_adjustment_get_upper(adj) - gtk_adjustment_get_page_size(adj) - 1;
+}
+
+static void flush(uiMultilineEntry *e)
+{
+	GtkTextIter end;
+	gboolean follow;
+
+	if (e->pending->len == 0)
+		return;
+	follow = atBottom(e);
+	// we need to inhibit sending of ::changed because this WILL send a ::changed otherwise
+	g_signal_handler_block(e->textbuf, e->onChangedSignal);
+	gtk_text_buffer_get_end_iter(e->textbuf, &end);
+	gtk_text_buffer_insert(e->textbuf, &end, e->pending->str, e->pending->len);
+	trimLines(e);
+	g_signal_handler_unblock(e->textbuf, e->onChangedSignal);
+	g_string_truncate(e->pending, 0);
+	// if the user was following along at the bottom, keep them there
+	// scrolling to a mark, unlike scrolling to an iter, doesn't need every line above it laid out first; the view does that lazily as it goes
+	if (follow)
+		gtk_text_view_scroll_mark_onscreen(e->textview, e->endMark);
+}
+
+static gboolean onTick(GtkWidget *widget, GdkFrameClock *clock, gpointer data)
+{
+	uiMultilineEntry *e = uiMultilineEntry(data);
+
+	e->tickCallback = 0;
+	flush(e);
+	return G_SOURCE_REMOVE;
+}
+
 char *uiMultilineEntryText(uiMultilineEntry *e)
 {
 	GtkTextIter start, end;
-	char *tret, *out;
 
+	flush(e);
 	gtk_text_buffer_get_start_iter(e->textbuf, &start);
 	gtk_text_buffer_get_end_iter(e->textbuf, &end);
-	tret = gtk_text_buffer_get_text(e->textbuf, &start, &end, TRUE);
-	// theoretically we could just return tret because uiUnixStrdupText() is just g_strdup(), but if that ever changes we can't, so let's do it this way to be safe
-	out = uiUnixStrdupText(tret);
-	g_free(tret);
-	return out;
+	// uiUnixStrdupText() is g_strdup() and uiFreeText() is g_free(), so there's no need to copy this a second time just to hand it out; for big buffers that copy adds up
+	return gtk_text_buffer_get_text(e->textbuf, &start, &end, TRUE);
+}
+
+int uiMultilineEntryNumLines(uiMultilineEntry *e)
+{
+	flush(e);
+	return gtk_text_buffer_get_line_count(e->textbuf);
+}
+
+char *uiMultilineEntryTextRange(uiMultilineEntry *e, int firstLine, int nLines)
+{
+	GtkTextIter start, end;
+
+	flush(e);
+	if (firstLine < 0 || nLines < 0 || firstLine + nLines > gtk_text_buffer_get_line_count(e->textbuf))
+		uiprivUserBug("Line range [%d, %d) out of range in uiMultilineEntryTextRange(). (multiline entry: %p)", firstLine, firstLine + nLines, e);
+	gtk_text_buffer_get_iter_at_line(e->textbuf, &start, firstLine);
+	gtk_text_buffer_get_iter_at_line(e->textbuf, &end, firstLine + nLines);
+	if (firstLine + nLines == gtk_text_buffer_get_line_count(e->textbuf))
+		gtk_text_buffer_get_end_iter(e->textbuf, &end);
+	// see uiMultilineEntryText()
+	return gtk_text_buffer_get_text(e->textbuf, &start, &end, TRUE);
 }
 
 void uiMultilineEntrySetText(uiMultilineEntry *e, const char *text)
 {
+	// anything still pending would have gone before this, so it's gone now too
+	g_string_truncate(e->pending, 0);
 	// we need to inhibit sending of ::changed because this WILL send a ::changed otherwise
 	g_signal_handler_block(e->textbuf, e->onChangedSignal);
 	gtk_text_buffer_set_text(e->textbuf, text, -1);
+	trimLines(e);
 	g_signal_handler_unblock(e->textbuf, e->onChangedSignal);
 }
 
-// TODO scroll to end?
+// appending to a GtkTextBuffer revalidates and redraws the view each time, so for a log pane that gets many appends a frame, we collect them and insert them all at once on the next frame
+// if the view isn't on screen, there is no next frame, so we insert right away
 void uiMultilineEntryAppend(uiMultilineEntry *e, const char *text)
 {
-	GtkTextIter end;
+	g_string_append(e->pending, text);
+	if (!gtk_widget_get_mapped(e->textviewWidget)) {
+		flush(e);
+		return;
+	}
+	if (e->tickCallback == 0)
+		e->tickCallback = gtk_widget_add_tick_callback(e->textviewWidget, onTick, e, NULL);
+}
 
-	gtk_text_buffer_get_end_iter(e->textbuf, &end);
-	// we need to inhibit sending of ::changed because this WILL send a ::changed otherwise
+int uiMultilineEntryMaxLines(uiMultilineEntry *e)
+{
+	return e->maxLines;
+}
+
+void uiMultilineEntrySetMaxLines(uiMultilineEntry *e, int maxLines)
+{
+	if (maxLines < 0)
+		maxLines = 0;
+	e->maxLines = maxLines;
+	flush(e);
 	g_signal_handler_block(e->textbuf, e->onChangedSignal);
-	gtk_text_buffer_insert(e->textbuf, &end, text, -1);
+	trimLines(e);
 	g_signal_handler_unblock(e->textbuf, e->onChangedSignal);
 }
 
@@ -70,6 +192,11 @@ void uiMultilineEntryOnChanged(uiMultilineEntry *e, void (*f)(uiMultilineEntry *
 	e->onChangedData = data;
 }
 
+void uiMultilineEntrySetChangePolicy(uiMultilineEntry *e, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(e->throttle, policy, milliseconds);
+}
+
 int uiMultilineEntryReadOnly(uiMultilineEntry *e)
 {
 	return gtk_text_view_get_editable(e->textview) == FALSE;
@@ -88,6 +215,7 @@ void uiMultilineEntrySetReadOnly(uiMultilineEntry *e, int readonly)
 static uiMultilineEntry *finishMultilineEntry(GtkPolicyType hpolicy, GtkWrapMode wrapMode)
 {
 	uiMultilineEntry *e;
+	GtkTextIter end;
 
 	uiUnixNewControl(uiMultilineEntry, e);
 
@@ -108,7 +236,12 @@ static uiMultilineEntry *finishMultilineEntry(GtkPolicyType hpolicy, GtkWrapMode
 	gtk_widget_show(e->textviewWidget);
 
 	e->textbuf = gtk_text_view_get_buffer(e->textview);
+	e->pending = g_string_new("");
+	gtk_text_buffer_get_end_iter(e->textbuf, &end);
+	// with right gravity, this stays at the end as text is inserted there
+	e->endMark = gtk_text_buffer_create_mark(e->textbuf, NULL, &end, FALSE);
 
+	e->throttle = uiprivNewThrottle(fireChanged, e);
 	e->onChangedSignal = g_signal_connect(e->textbuf, "changed", G_CALLBACK(onChanged), e);
 	uiMultilineEntryOnChanged(e, defaultOnChanged, NULL);
 
@@ -13,14 +13,21 @@ static uiForEach toCSS(const uiOpenTypeFeatures *otf, char a, char b, char c, ch
 	return uiForEachContinue;
 }
 
-GString *uiprivOpenTypeFeaturesToPangoCSSFeaturesString(const uiOpenTypeFeatures *otf)
+// the string is cached in otf until otf changes, so every attribute and layout that uses the same features shares it
+const char *uiprivOpenTypeFeaturesToPangoCSSFeaturesString(const uiOpenTypeFeatures *otf)
 {
 	GString *s;
+	char *str;
 
+	str = (char *) uiprivOpenTypeFeaturesOSData(otf);
+	if (str != NULL)
+		return str;
 	s = g_string_new("");
 	uiOpenTypeFeaturesForEach(otf, toCSS, s);
 	if (s->len != 0)
 		// and remove the last comma
 		g_string_truncate(s, s->len - 2);
-	return s;
+	str = g_string_free(s, FALSE);
+	uiprivOpenTypeFeaturesSetOSData(otf, str, g_free);
+	return str;
 }
@@ -0,0 +1,132 @@
+// 19 october 2026
+#include "uipriv_unix.h"
+
+// the calling thread works too, so this is the most extra threads we'll use
+#define maxThreads 64
+
+// the helper threads are kept in one GThreadPool for the life of the program (until uiUninit()), so a call only has to wake them up, not start them
+// the pool is exclusive so its threads stay around between calls instead of going back to GLib's shared pool, which only keeps a couple idle threads
+// a call hands out items until they run out and waits until every item is done, not until every helper it asked for has run; a helper that only gets to run after that finds nothing left to do
+// that way a call never waits on a helper that hasn't started, which would deadlock if f itself calls uiprivParallelFor() from every pool thread at once
+// for the same reason, the call's state is reference-counted instead of living on the caller's stack
+struct parallel {
+	uiprivParallelFunc f;
+	void *data;
+	guint n;
+	guint next;
+	gint refcount;
+	GMutex mutex;
+	GCond cond;
+	guint done;		// protected by mutex
+};
+
+static GThreadPool *pool = NULL;
+static guint poolThreads = 0;
+static GMutex poolMutex;
+
+// this can outlive the call that made it, and runs on other threads, so it can't use uiprivAlloc()
+static void unref(struct parallel *p)
+{
+	if (!g_atomic_int_dec_and_test(&(p->refcount)))
+		return;
+	g_mutex_clear(&(p->mutex));
+	g_cond_clear(&(p->cond));
+	g_free(p);
+}
+
+static void work(struct parallel *p)
+{
+	guint i, did;
+
+	did = 0;
+	for (;;) {
+		i = (guint) g_atomic_int_add((gint *) (&(p->next)), 1);
+		if (i >= p->n)
+			break;
+		(*(p->f))(p->data, i);
+		did++;
+	}
+	if (did == 0)
+		return;
+	g_mutex_lock(&(p->mutex));
+	p->done += did;
+	if (p->done == p->n)
+		g_cond_signal(&(p->cond));
+	g_mutex_unlock(&(p->mutex));
+}
+
+static void helper(gpointer data, gpointer unused)
+{
+	struct parallel *p = (struct parallel *) data;
+
+	work(p);
+	unref(p);
+}
+
+static GThreadPool *getPool(guint *nThreads)
+{
+	GError *err = NULL;
+
+	g_mutex_lock(&poolMutex);
+	if (pool == NULL) {
+		poolThreads = g_get_num_processors() - 1;
+		if (poolThreads > maxThreads)
+			poolThreads = maxThreads;
+		if (poolThreads != 0) {
+			pool = g_thread_pool_new(helper, NULL, poolThreads, TRUE, &err);
+			if (pool == NULL)
+				uiprivImplBug("error creating parallel thread pool: %s", err->message);
+		}
+	}
+	*nThreads = poolThreads;
+	g_mutex_unlock(&poolMutex);
+	return pool;
+}
+
+void uiprivParallelFor(size_t n, uiprivParallelFunc f, void *data)
+{
+	struct parallel *p;
+	GThreadPool *tp;
+	guint i, nThreads;
+
+	if (n == 0)
+		return;
+	if (n > G_MAXINT)
+		uiprivImplBug("too many work items passed to uiprivParallelFor()");
+	tp = getPool(&nThreads);
+	if (nThreads > n - 1)
+		nThreads = n - 1;
+	if (nThreads == 0) {
+		for (i = 0; i < n; i++)
+			(*f)(data, i);
+		return;
+	}
+
+	p = g_new0(struct parallel, 1);
+	p->f = f;
+	p->data = data;
+	p->n = (guint) n;
+	p->next = 0;
+	p->refcount = 1 + nThreads;
+	g_mutex_init(&(p->mutex));
+	g_cond_init(&(p->cond));
+	for (i = 0; i < nThreads; i++)
+		g_thread_pool_push(tp, p, NULL);
+	work(p);
+	g_mutex_lock(&(p->mutex));
+	while (p->done != p->n)
+		g_cond_wait(&(p->cond), &(p->mutex));
+	g_mutex_unlock(&(p->mutex));
+	unref(p);
+}
+
+void uiprivUninitParallel(void)
+{
+	g_mutex_lock(&poolMutex);
+	if (pool != NULL)
+		// every call has already waited for its items, so any tasks left are helpers with nothing to do
+		g_thread_pool_free(pool, FALSE, TRUE);
+	pool = NULL;
+	poolThreads = 0;
+	g_mutex_unlock(&poolMutex);
+}
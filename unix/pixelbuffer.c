@@ -0,0 +1,216 @@
+// 19 october 2026
+#include "uipriv_unix.h"
+#include "draw.h"
+
+// A uiPixelBuffer has two image surfaces: front holds the last published frame and back is the one being written.
+// uiPixelBufferUnmap() swaps them. The new back buffer is then one frame behind, so the next uiPixelBufferMap() copies the rows the last frame changed over from front before handing back out; everything else is already identical.
+// Drawing doesn't use front directly. Instead, it keeps a display surface made with cairo_surface_create_similar() on whatever the uiArea draws to (usually an X pixmap or similar), and only the rectangle that changed since the last draw is uploaded into it.
+// The mutex protects the swap and the pending upload rectangle; only the mapping thread ever writes to back, and front never changes while the mapping thread isn't inside uiPixelBufferUnmap(), so the pixels themselves don't need it.
+
+struct dirtyRect {
+	int x0, y0;
+	int x1, y1;		// exclusive; x0 == x1 means empty
+};
+
+struct uiPixelBuffer {
+	int width;
+	int height;
+	GMutex lock;
+	cairo_surface_t *front;
+	cairo_surface_t *back;
+	gboolean mapped;
+	struct dirtyRect carry;		// changed in front but not in back
+	struct dirtyRect upload;		// changed in front but not in display
+	cairo_surface_t *display;
+};
+
+static void dirtyUnion(struct dirtyRect *r, int x0, int y0, int x1, int y1)
+{
+	if (r->x0 == r->x1) {
+		r->x0 = x0;
+		r->y0 = y0;
+		r->x1 = x1;
+		r->y1 = y1;
+		return;
+	}
+	if (r->x0 > x0)
+		r->x0 = x0;
+	if (r->y0 > y0)
+		r->y0 = y0;
+	if (r->x1 < x1)
+		r->x1 = x1;
+	if (r->y1 < y1)
+		r->y1 = y1;
+}
+
+static void dirtyClear(struct dirtyRect *r)
+{
+	r->x0 = 0;
+	r->y0 = 0;
+	r->x1 = 0;
+	r->y1 = 0;
+}
+
+uiPixelBuffer *uiNewPixelBuffer(int pixelWidth, int pixelHeight)
+{
+	uiPixelBuffer *pb;
+
+	pb = uiprivNew(uiPixelBuffer);
+	pb->width = pixelWidth;
+	pb->height = pixelHeight;
+	g_mutex_init(&(pb->lock));
+	// cairo image surfaces start out cleared to transparent
+	pb->front = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pixelWidth, pixelHeight);
+	pb->back = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pixelWidth, pixelHeight);
+	return pb;
+}
+
+void uiFreePixelBuffer(uiPixelBuffer *pb)
+{
+	if (pb->mapped)
+		uiprivUserBug("You cannot free a uiPixelBuffer while it is mapped. (pixel buffer: %p)", pb);
+	if (pb->display != NULL)
+		cairo_surface_destroy(pb->display);
+	cairo_surface_destroy(pb->back);
+	cairo_surface_destroy(pb->front);
+	g_mutex_clear(&(pb->lock));
+	uiprivFree(pb);
+}
+
+static void copyRows(cairo_surface_t *dst, cairo_surface_t *src, const struct dirtyRect *r)
+{
+	uint8_t *d, *s;
+	int stride;
+	int y;
+
+	stride = cairo_image_surface_get_stride(src);
+	d = cairo_image_surface_get_data(dst) + r->y0 * stride + r->x0 * 4;
+	s = cairo_image_surface_get_data(src) + r->y0 * stride + r->x0 * 4;
+	if (r->x0 == 0 && r->x1 == cairo_image_surface_get_width(src)) {
+		// whole rows are contiguous
+		memcpy(d, s, (r->y1 - r->y0) * stride);
+		return;
+	}
+	for (y = r->y0; y < r->y1; y++) {
+		memcpy(d, s, (r->x1 - r->x0) * 4);
+		d += stride;
+		s += stride;
+	}
+}
+
+void *uiPixelBufferMap(uiPixelBuffer *pb, int *byteStride)
+{
+	if (pb->mapped)
+		uiprivUserBug("You cannot map a uiPixelBuffer that is already mapped. (pixel buffer: %p)", pb);
+	pb->mapped = TRUE;
+	cairo_surface_flush(pb->back);
+	if (pb->carry.x0 != pb->carry.x1) {
+		copyRows(pb->back, pb->front, &(pb->carry));
+		cairo_surface_mark_dirty_rectangle(pb->back,
+			pb->carry.x0, pb->carry.y0,
+			pb->carry.x1 - pb->carry.x0, pb->carry.y1 - pb->carry.y0);
+		dirtyClear(&(pb->carry));
+	}
+	*byteStride = cairo_image_surface_get_stride(pb->back);
+	return cairo_image_surface_get_data(pb->back);
+}
+
+void uiPixelBufferUnmap(uiPixelBuffer *pb, int x, int y, int width, int height)
+{
+	cairo_surface_t *s;
+	int x0, y0, x1, y1;
+
+	if (!pb->mapped)
+		uiprivUserBug("You cannot unmap a uiPixelBuffer that is not mapped. (pixel buffer: %p)", pb);
+	pb->mapped = FALSE;
+
+	x0 = x;
+	y0 = y;
+	x1 = x + width;
+	y1 = y + height;
+	if (x0 < 0)
+		x0 = 0;
+	if (y0 < 0)
+		y0 = 0;
+	if (x1 > pb->width)
+		x1 = pb->width;
+	if (y1 > pb->height)
+		y1 = pb->height;
+	if (x0 >= x1 || y0 >= y1)
+		// nothing changed; don't bother swapping
+		return;
+	cairo_surface_mark_dirty_rectangle(pb->back, x0, y0, x1 - x0, y1 - y0);
+
+	g_mutex_lock(&(pb->lock));
+	s = pb->front;
+	pb->front = pb->back;
+	pb->back = s;
+	dirtyUnion(&(pb->upload), x0, y0, x1, y1);
+	g_mutex_unlock(&(pb->lock));
+	// only this thread reads carry
+	dirtyUnion(&(pb->carry), x0, y0, x1, y1);
+}
+
+// must be called with pb->lock held
+static void uploadDirty(uiPixelBuffer *pb, cairo_t *target)
+{
+	cairo_surface_t *t;
+	cairo_t *cr;
+
+	t = cairo_get_target(target);
+	if (pb->display != NULL && cairo_surface_get_type(pb->display) != cairo_surface_get_type(t)) {
+		// the uiArea is drawing to something else now (for instance, it moved to another screen)
+		cairo_surface_destroy(pb->display);
+		pb->display = NULL;
+	}
+	if (pb->display == NULL) {
+		pb->display = cairo_surface_create_similar(t, CAIRO_CONTENT_COLOR_ALPHA, pb->width, pb->height);
+		dirtyClear(&(pb->upload));
+		dirtyUnion(&(pb->upload), 0, 0, pb->width, pb->height);
+	}
+	if (pb->upload.x0 == pb->upload.x1)
+		return;
+
+	cr = cairo_create(pb->display);
+	cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+	cairo_set_source_surface(cr, pb->front, 0, 0);
+	cairo_rectangle(cr,
+		pb->upload.x0, pb->upload.y0,
+		pb->upload.x1 - pb->upload.x0, pb->upload.y1 - pb->upload.y0);
+	cairo_fill(cr);
+	cairo_destroy(cr);
+	dirtyClear(&(pb->upload));
+}
+
+void uiDrawPixelBuffer(uiDrawContext *c, uiPixelBuffer *pb, double x, double y, double width, double height, uiDrawImageFilter filter)
+{
+	double cx0, cy0, cx1, cy1;
+
+	if (width <= 0 || height <= 0)
+		return;
+	cairo_clip_extents(c->cr, &cx0, &cy0, &cx1, &cy1);
+	if (x >= cx1 || y >= cy1 || x + width <= cx0 || y + height <= cy0)
+		return;
+
+	g_mutex_lock(&(pb->lock));
+	uploadDirty(pb, c->cr);
+	g_mutex_unlock(&(pb->lock));
+
+	cairo_save(c->cr);
+	cairo_rectangle(c->cr, x, y, width, height);
+	cairo_clip(c->cr);
+	cairo_translate(c->cr, x, y);
+	cairo_scale(c->cr, width / pb->width, height / pb->height);
+	cairo_set_source_surface(c->cr, pb->display, 0, 0);
+	switch (filter) {
+	case uiDrawImageFilterNearest:
+		cairo_pattern_set_filter(cairo_get_source(c->cr), CAIRO_FILTER_NEAREST);
+		break;
+	case uiDrawImageFilterLinear:
+		cairo_pattern_set_filter(cairo_get_source(c->cr), CAIRO_FILTER_BILINEAR);
+		break;
+	}
+	cairo_pattern_set_extend(cairo_get_source(c->cr), CAIRO_EXTEND_PAD);
+	cairo_paint(c->cr);
+	cairo_restore(c->cr);
+}
@@ -64,6 +64,29 @@ void uiRadioButtonsAppend(uiRadioButtons *r, const char *text)
 	gtk_widget_show(rb);
 }
 
+void uiRadioButtonsSetItems(uiRadioButtons *r, const char *const *items, int n)
+{
+	GtkWidget *b;
+	gboolean visible;
+	int i;
+
+	// while the box is hidden, adding and removing buttons doesn't make anything above it re-measure; we do that once at the end instead
+	visible = gtk_widget_get_visible(r->widget);
+	if (visible)
+		gtk_widget_hide(r->widget);
+	// none of the buttons being destroyed or made here should look like the user clicked them
+	r->changing = TRUE;
+	while (r->buttons->len != 0) {
+		b = GTK_WIDGET(g_ptr_array_remove_index(r->buttons, r->buttons->len - 1));
+		gtk_widget_destroy(b);
+	}
+	for (i = 0; i < n; i++)
+		uiRadioButtonsAppend(r, items[i]);
+	r->changing = FALSE;
+	if (visible)
+		gtk_widget_show(r->widget);
+}
+
 int uiRadioButtonsSelected(uiRadioButtons *r)
 {
 	GtkToggleButton *tb;
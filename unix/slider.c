@@ -9,14 +9,31 @@ struct uiSlider {
 	void (*onChanged)(uiSlider *, void *);
 	void *onChangedData;
 	gulong onChangedSignal;
+	uiprivThrottle *throttle;
 };
 
-uiUnixControlAllDefaults(uiSlider)
+uiUnixControlAllDefaultsExceptDestroy(uiSlider)
+
+static void uiSliderDestroy(uiControl *c)
+{
+	uiSlider *s = uiSlider(c);
+
+	uiprivFreeThrottle(s->throttle);
+	g_object_unref(s->widget);
+	uiFreeControl(uiControl(s));
+}
 
 static void onChanged(GtkRange *range, gpointer data)
 {
 	uiSlider *s = uiSlider(data);
 
+	uiprivThrottleNotify(s->throttle);
+}
+
+static void fireChanged(void *data)
+{
+	uiSlider *s = uiSlider(data);
+
 	(*(s->onChanged))(s, s->onChangedData);
 }
 
@@ -44,6 +61,11 @@ void uiSliderOnChanged(uiSlider *s, void (*f)(uiSlider *, void *), void *data)
 	s->onChangedData = data;
 }
 
+void uiSliderSetChangePolicy(uiSlider *s, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(s->throttle, policy, milliseconds);
+}
+
 uiSlider *uiNewSlider(int min, int max)
 {
 	uiSlider *s;
@@ -64,6 +86,7 @@ uiSlider *uiNewSlider(int min, int max)
 	// ensure integers, just to be safe
 	gtk_scale_set_digits(s->scale, 0);
 
+	s->throttle = uiprivNewThrottle(fireChanged, s);
 	s->onChangedSignal = g_signal_connect(s->scale, "value-changed", G_CALLBACK(onChanged), s);
 	uiSliderOnChanged(s, defaultOnChanged, NULL);
 
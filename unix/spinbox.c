@@ -9,14 +9,31 @@ struct uiSpinbox {
 	void (*onChanged)(uiSpinbox *, void *);
 	void *onChangedData;
 	gulong onChangedSignal;
+	uiprivThrottle *throttle;
 };
 
-uiUnixControlAllDefaults(uiSpinbox)
+uiUnixControlAllDefaultsExceptDestroy(uiSpinbox)
+
+static void uiSpinboxDestroy(uiControl *c)
+{
+	uiSpinbox *s = uiSpinbox(c);
+
+	uiprivFreeThrottle(s->throttle);
+	g_object_unref(s->widget);
+	uiFreeControl(uiControl(s));
+}
 
 static void onChanged(GtkSpinButton *sb, gpointer data)
 {
 	uiSpinbox *s = uiSpinbox(data);
 
+	uiprivThrottleNotify(s->throttle);
+}
+
+static void fireChanged(void *data)
+{
+	uiSpinbox *s = uiSpinbox(data);
+
 	(*(s->onChanged))(s, s->onChangedData);
 }
 
@@ -45,6 +62,11 @@ void uiSpinboxOnChanged(uiSpinbox *s, void (*f)(uiSpinbox *, void *), void *data
 	s->onChangedData = data;
 }
 
+void uiSpinboxSetChangePolicy(uiSpinbox *s, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(s->throttle, policy, milliseconds);
+}
+
 uiSpinbox *uiNewSpinbox(int min, int max)
 {
 	uiSpinbox *s;
@@ -65,6 +87,7 @@ uiSpinbox *uiNewSpinbox(int min, int max)
 	// ensure integers, just to be safe
 	gtk_spin_button_set_digits(s->spinButton, 0);
 
+	s->throttle = uiprivNewThrottle(fireChanged, s);
 	s->onChangedSignal = g_signal_connect(s->spinButton, "value-changed", G_CALLBACK(onChanged), s);
 	uiSpinboxOnChanged(s, defaultOnChanged, NULL);
 
@@ -6,12 +6,10 @@
 
 #define windowWindow(w) (GTK_WINDOW(uiControlHandle(uiControl(w))))
 
-static char *filedialog(GtkWindow *parent, GtkFileChooserAction mode, const gchar *confirm)
+static GtkWidget *newFileDialog(GtkWindow *parent, GtkFileChooserAction mode, const gchar *confirm, gboolean multiple)
 {
 	GtkWidget *fcd;
 	GtkFileChooser *fc;
-	gint response;
-	char *filename;
 
 	fcd = gtk_file_chooser_dialog_new(NULL, parent, mode,
 		"_Cancel", GTK_RESPONSE_CANCEL,
@@ -19,17 +17,28 @@ static char *filedialog(GtkWindow *parent, GtkFileChooserAction mode, const gcha
 		NULL);
 	fc = GTK_FILE_CHOOSER(fcd);
 	gtk_file_chooser_set_local_only(fc, FALSE);
-	gtk_file_chooser_set_select_multiple(fc, FALSE);
+	gtk_file_chooser_set_select_multiple(fc, multiple);
 	gtk_file_chooser_set_show_hidden(fc, TRUE);
 	gtk_file_chooser_set_do_overwrite_confirmation(fc, TRUE);
 	gtk_file_chooser_set_create_folders(fc, TRUE);
+	return fcd;
+}
+
+static char *filedialog(GtkWindow *parent, GtkFileChooserAction mode, const gchar *confirm)
+{
+	GtkWidget *fcd;
+	gint response;
+	char *filename;
+
+	fcd = newFileDialog(parent, mode, confirm, FALSE);
 	response = gtk_dialog_run(GTK_DIALOG(fcd));
 	if (response != GTK_RESPONSE_ACCEPT) {
 		gtk_widget_destroy(fcd);
 		return NULL;
 	}
-	filename = uiUnixStrdupText(gtk_file_chooser_get_filename(fc));
+	filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(fcd));
 	gtk_widget_destroy(fcd);
+	// this is already our own copy, and uiFreeText() is g_free(), so there's no need to copy it again (this used to, and leaked this one)
 	return filename;
 }
 
@@ -43,7 +52,96 @@ char *uiSaveFile(uiWindow *parent)
 	return filedialog(windowWindow(parent), GTK_FILE_CHOOSER_ACTION_SAVE, "_Save");
 }
 
-static void msgbox(GtkWindow *parent, const char *title, const char *description, GtkMessageType type, GtkButtonsType buttons)
+// the async versions show the dialog modally but don't wait for it; instead of a nested main loop from gtk_dialog_run(), the answer comes back through ::response on the one main loop there is
+// these are freed when the dialog closes, which may be after uiUninit() if the program quits with one open, so they can't use uiprivAlloc()
+// the dialogs are destroyed along with their parent, and then they go away without a ::response, so f is never called with a parent that's already gone; that's why these are freed with the signal handler and not by it
+struct asyncFileDialog {
+	uiWindow *parent;
+	void (*f)(uiWindow *, const char *, void *);
+	void (*multiple)(uiWindow *, const char *const *, int, void *);
+	void *data;
+};
+
+static void freeAsync(gpointer data, GClosure *closure)
+{
+	g_free(data);
+}
+
+static void onFileDialogResponse(GtkDialog *dialog, gint response, gpointer data)
+{
+	// destroying the dialog frees data, so take a copy first
+	struct asyncFileDialog a = *((struct asyncFileDialog *) data);
+	GSList *list, *l;
+	char *filename;
+	char **filenames;
+	int i, n;
+
+	if (a.multiple != NULL) {
+		list = NULL;
+		if (response == GTK_RESPONSE_ACCEPT)
+			list = gtk_file_chooser_get_filenames(GTK_FILE_CHOOSER(dialog));
+		n = g_slist_length(list);
+		filenames = g_new0(char *, n + 1);
+		for (i = 0, l = list; l != NULL; i++, l = l->next)
+			filenames[i] = (char *) (l->data);
+		g_slist_free(list);
+		// destroy the dialog first so the handler can open another one
+		gtk_widget_destroy(GTK_WIDGET(dialog));
+		(*(a.multiple))(a.parent, (const char *const *) filenames, n, a.data);
+		g_strfreev(filenames);
+	} else {
+		filename = NULL;
+		if (response == GTK_RESPONSE_ACCEPT)
+			filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+		gtk_widget_destroy(GTK_WIDGET(dialog));
+		(*(a.f))(a.parent, filename, a.data);
+		g_free(filename);
+	}
+}
+
+static void fileDialogAsync(uiWindow *parent, GtkFileChooserAction mode, const gchar *confirm, struct asyncFileDialog *a)
+{
+	GtkWidget *fcd;
+
+	a->parent = parent;
+	fcd = newFileDialog(windowWindow(parent), mode, confirm, a->multiple != NULL);
+	gtk_window_set_modal(GTK_WINDOW(fcd), TRUE);
+	gtk_window_set_destroy_with_parent(GTK_WINDOW(fcd), TRUE);
+	g_signal_connect_data(fcd, "response", G_CALLBACK(onFileDialogResponse), a, freeAsync, 0);
+	gtk_widget_show(fcd);
+}
+
+void uiOpenFileAsync(uiWindow *parent, void (*f)(uiWindow *parent, const char *filename, void *data), void *data)
+{
+	struct asyncFileDialog *a;
+
+	a = g_new0(struct asyncFileDialog, 1);
+	a->f = f;
+	a->data = data;
+	fileDialogAsync(parent, GTK_FILE_CHOOSER_ACTION_OPEN, "_Open", a);
+}
+
+void uiOpenFilesAsync(uiWindow *parent, void (*f)(uiWindow *parent, const char *const *filenames, int n, void *data), void *data)
+{
+	struct asyncFileDialog *a;
+
+	a = g_new0(struct asyncFileDialog, 1);
+	a->multiple = f;
+	a->data = data;
+	fileDialogAsync(parent, GTK_FILE_CHOOSER_ACTION_OPEN, "_Open", a);
+}
+
+void uiSaveFileAsync(uiWindow *parent, void (*f)(uiWindow *parent, const char *filename, void *data), void *data)
+{
+	struct asyncFileDialog *a;
+
+	a = g_new0(struct asyncFileDialog, 1);
+	a->f = f;
+	a->data = data;
+	fileDialogAsync(parent, GTK_FILE_CHOOSER_ACTION_SAVE, "_Save", a);
+}
+
+static GtkWidget *newMsgBox(GtkWindow *parent, const char *title, const char *description, GtkMessageType type, GtkButtonsType buttons)
 {
 	GtkWidget *md;
 
@@ -51,6 +149,14 @@ static void msgbox(GtkWindow *parent, const char *title, const char *description
 		type, buttons,
 		"%s", title);
 	gtk_message_dialog_format_secondary_text(GTK_MESSAGE_DIALOG(md), "%s", description);
+	return md;
+}
+
+static void msgbox(GtkWindow *parent, const char *title, const char *description, GtkMessageType type, GtkButtonsType buttons)
+{
+	GtkWidget *md;
+
+	md = newMsgBox(parent, title, description, type, buttons);
 	gtk_dialog_run(GTK_DIALOG(md));
 	gtk_widget_destroy(md);
 }
@@ -64,3 +170,43 @@ void uiMsgBoxError(uiWindow *parent, const char *title, const char *description)
 {
 	msgbox(windowWindow(parent), title, description, GTK_MESSAGE_ERROR, GTK_BUTTONS_OK);
 }
+
+struct asyncMsgBox {
+	uiWindow *parent;
+	void (*f)(uiWindow *, void *);
+	void *data;
+};
+
+static void onMsgBoxResponse(GtkDialog *dialog, gint response, gpointer data)
+{
+	struct asyncMsgBox a = *((struct asyncMsgBox *) data);
+
+	gtk_widget_destroy(GTK_WIDGET(dialog));
+	if (a.f != NULL)
+		(*(a.f))(a.parent, a.data);
+}
+
+static void msgboxAsync(uiWindow *parent, const char *title, const char *description, GtkMessageType type, void (*f)(uiWindow *, void *), void *data)
+{
+	GtkWidget *md;
+	struct asyncMsgBox *a;
+
+	a = g_new0(struct asyncMsgBox, 1);
+	a->parent = parent;
+	a->f = f;
+	a->data = data;
+	md = newMsgBox(windowWindow(parent), title, description, type, GTK_BUTTONS_OK);
+	gtk_window_set_destroy_with_parent(GTK_WINDOW(md), TRUE);
+	g_signal_connect_data(md, "response", G_CALLBACK(onMsgBoxResponse), a, freeAsync, 0);
+	gtk_widget_show(md);
+}
+
+void uiMsgBoxAsync(uiWindow *parent, const char *title, const char *description, void (*f)(uiWindow *parent, void *data), void *data)
+{
+	msgboxAsync(parent, title, description, GTK_MESSAGE_OTHER, f, data);
+}
+
+void uiMsgBoxErrorAsync(uiWindow *parent, const char *title, const char *description, void (*f)(uiWindow *parent, void *data), void *data)
+{
+	msgboxAsync(parent, title, description, GTK_MESSAGE_ERROR, f, data);
+}
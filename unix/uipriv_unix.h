@@ -28,6 +28,10 @@ extern void uiprivUninitMenus(void);
 extern void uiprivInitAlloc(void);
 extern void uiprivUninitAlloc(void);
 
+// control.c
+extern gboolean uiprivControlUpdating(uiControl *c);
+extern void uiprivControlDeferUpdate(uiControl *c, void (*f)(uiControl *));
+
 // util.c
 extern void uiprivSetMargined(GtkContainer *, int);
 
@@ -45,14 +49,35 @@ extern void uiprivChildSetMargined(uiprivChild *c, int margined);
 
 // draw.c
 extern uiDrawContext *uiprivNewContext(cairo_t *cr, GtkStyleContext *style);
+extern void uiprivContextBeginFrame(uiDrawContext *c, cairo_t *cr, GtkStyleContext *style);
+extern void uiprivContextEndFrame(uiDrawContext *c);
 extern void uiprivFreeContext(uiDrawContext *);
 
+// drawtext.c
+extern void uiprivUninitDrawText(void);
+
+// fontmatch.c
+extern void uiprivUninitFontMatch(void);
+
+// parallel.c
+extern void uiprivUninitParallel(void);
+
 // image.c
 extern cairo_surface_t *uiprivImageAppropriateSurface(uiImage *i, GtkWidget *w);
 
 // cellrendererbutton.c
 extern GtkCellRenderer *uiprivNewCellRendererButton(void);
 
+// combomodel.c
+typedef const char *(*uiprivComboModelItemFunc)(gpointer owner, int i);
+extern GtkTreeModel *uiprivNewComboListModel(const char *const *items, int n);
+extern GtkTreeModel *uiprivNewComboVirtualModel(int n, uiprivComboModelItemFunc f, gpointer owner);
+extern void uiprivComboBoxSetVirtualModel(GtkComboBox *cb, GtkTreeModel *m, gulong changedSignal);
+extern void uiprivComboBoxSetModel(GtkComboBox *cb, GtkTreeModel *m, gulong changedSignal);
+extern gboolean uiprivComboBoxIsVirtual(GtkComboBox *cb);
+extern gint uiprivComboBoxActive(GtkComboBox *cb);
+extern void uiprivComboBoxSetActive(GtkComboBox *cb, gint n);
+
 // future.c
 extern void uiprivLoadFutures(void);
 extern PangoAttribute *uiprivFUTURE_pango_attr_font_features_new(const gchar *features);
@@ -0,0 +1,255 @@
+// 19 october 2026
+#include "uipriv_unix.h"
+
+// a uiVirtualBox is a GtkScrolledWindow around a GtkLayout; the GtkLayout is made as tall as all the items would be, but only holds enough item controls to cover what's visible
+// those controls live in slots, each bound to one item index (or to none); scrolling rebinds the slots that scrolled out of view to the items that scrolled into it
+// all items are the same height, which is what makes finding the visible ones (and sizing the GtkLayout) free
+// scrolling and resizing only note that something changed; the rebinding happens in a tick callback at the start of the next frame, before GTK+ lays anything out, since changing size requests and moving children from inside ::size-allocate would queue another resize in the middle of the one that's running
+
+struct slot {
+	uiControl *c;
+	int index;		// -1 if not bound to any item
+};
+
+struct uiVirtualBox {
+	uiUnixControl c;
+	GtkWidget *widget;
+	GtkContainer *scontainer;
+	GtkScrolledWindow *sw;
+	GtkWidget *layoutWidget;
+	GtkContainer *lcontainer;
+	GtkLayout *layout;
+	GtkAdjustment *vadj;
+	uiVirtualBoxHandler *h;
+	int n;
+	int itemHeight;
+	int width;
+	GArray *slots;
+	guint tickCallback;
+};
+
+uiUnixControlAllDefaultsExceptDestroy(uiVirtualBox)
+
+#define slot(vb, i) &g_array_index(vb->slots, struct slot, i)
+
+static void uiVirtualBoxDestroy(uiControl *c)
+{
+	uiVirtualBox *vb = uiVirtualBox(c);
+	struct slot *s;
+	guint i;
+
+	if (vb->tickCallback != 0)
+		gtk_widget_remove_tick_callback(vb->layoutWidget, vb->tickCallback);
+	for (i = 0; i < vb->slots->len; i++) {
+		s = slot(vb, i);
+		uiControlSetParent(s->c, NULL);
+		// and make sure the widget itself stays alive
+		uiUnixControlSetContainer(uiUnixControl(s->c), vb->lcontainer, TRUE);
+		uiControlDestroy(s->c);
+	}
+	g_array_free(vb->slots, TRUE);
+	g_object_unref(vb->widget);
+	uiFreeControl(uiControl(vb));
+}
+
+static struct slot *newSlot(uiVirtualBox *vb)
+{
+	struct slot s;
+	GtkWidget *widget;
+	gint natural;
+
+	s.c = (*(vb->h->NewItem))(vb->h, vb);
+	s.index = -1;
+	uiControlSetParent(s.c, uiControl(vb));
+	uiUnixControlSetContainer(uiUnixControl(s.c), vb->lcontainer, FALSE);
+	widget = GTK_WIDGET(uiControlHandle(s.c));
+	gtk_widget_set_child_visible(widget, FALSE);
+	if (vb->itemHeight <= 0) {
+		gtk_widget_get_preferred_height(widget, NULL, &natural);
+		vb->itemHeight = natural;
+		if (vb->itemHeight <= 0)
+			vb->itemHeight = 1;
+	}
+	gtk_widget_set_size_request(widget, vb->width, vb->itemHeight);
+	g_array_append_val(vb->slots, s);
+	return slot(vb, vb->slots->len - 1);
+}
+
+static void bind(uiVirtualBox *vb, struct slot *s, int index)
+{
+	GtkWidget *widget;
+
+	s->index = index;
+	(*(vb->h->BindItem))(vb->h, vb, s->c, index);
+	widget = GTK_WIDGET(uiControlHandle(s->c));
+	gtk_layout_move(vb->layout, widget, 0, index * vb->itemHeight);
+	gtk_widget_set_child_visible(widget, TRUE);
+}
+
+static void update(uiVirtualBox *vb)
+{
+	struct slot *s;
+	double value;
+	int height;
+	int first, last;
+	int i;
+	guint j, k;
+
+	if (vb->n != 0 && vb->itemHeight <= 0)
+		// make an item just to find out how tall items are
+		newSlot(vb);
+	gtk_layout_set_size(vb->layout, vb->width, vb->n * (vb->itemHeight > 0 ? vb->itemHeight : 0));
+	first = 0;
+	last = 0;
+	if (vb->n != 0) {
+		value = gtk_adjustment_get_value(vb->vadj);
+		height = gtk_widget_get_allocated_height(vb->layoutWidget);
+		first = (int) (value / vb->itemHeight);
+		last = (int) ((value + height) / vb->itemHeight) + 1;
+		if (first > vb->n)
+			first = vb->n;
+		if (last > vb->n)
+			last = vb->n;
+	}
+
+	// first free every slot whose item scrolled out of view
+	for (j = 0; j < vb->slots->len; j++) {
+		s = slot(vb, j);
+		if (s->index < first || s->index >= last)
+			s->index = -1;
+	}
+	// then give each visible item that doesn't have a slot a free one
+	// there are only ever as many slots as fit on screen, so the quadratic search doesn't matter
+	k = 0;
+	for (i = first; i < last; i++) {
+		for (j = 0; j < vb->slots->len; j++)
+			if (slot(vb, j)->index == i)
+				break;
+		if (j < vb->slots->len)
+			continue;
+		for (; k < vb->slots->len; k++)
+			if (slot(vb, k)->index == -1)
+				break;
+		if (k < vb->slots->len)
+			s = slot(vb, k);
+		else
+			s = newSlot(vb);
+		bind(vb, s, i);
+	}
+	// and hide whatever's left over
+	for (j = 0; j < vb->slots->len; j++) {
+		s = slot(vb, j);
+		if (s->index == -1)
+			gtk_widget_set_child_visible(GTK_WIDGET(uiControlHandle(s->c)), FALSE);
+	}
+}
+
+static gboolean onTick(GtkWidget *widget, GdkFrameClock *clock, gpointer data)
+{
+	uiVirtualBox *vb = uiVirtualBox(data);
+	struct slot *s;
+	int width;
+	guint i;
+
+	vb->tickCallback = 0;
+	width = gtk_widget_get_allocated_width(vb->layoutWidget);
+	if (width != vb->width) {
+		vb->width = width;
+		for (i = 0; i < vb->slots->len; i++) {
+			s = slot(vb, i);
+			gtk_widget_set_size_request(GTK_WIDGET(uiControlHandle(s->c)), vb->width, vb->itemHeight);
+		}
+	}
+	update(vb);
+	return G_SOURCE_REMOVE;
+}
+
+static void queueUpdate(uiVirtualBox *vb)
+{
+	if (vb->tickCallback == 0)
+		vb->tickCallback = gtk_widget_add_tick_callback(vb->layoutWidget, onTick, vb, NULL);
+}
+
+// GtkLayout also changes the adjustment from inside its own ::size-allocate, so this has to wait too
+static void onValueChanged(GtkAdjustment *adj, gpointer data)
+{
+	queueUpdate(uiVirtualBox(data));
+}
+
+static void onSizeAllocate(GtkWidget *widget, GdkRectangle *allocation, gpointer data)
+{
+	queueUpdate(uiVirtualBox(data));
+}
+
+int uiVirtualBoxNumItems(uiVirtualBox *vb)
+{
+	return vb->n;
+}
+
+void uiVirtualBoxSetNumItems(uiVirtualBox *vb, int n)
+{
+	guint i;
+
+	if (n < 0)
+		uiprivUserBug("You cannot give a uiVirtualBox a negative number of items. (virtual box: %p, count: %d)", vb, n);
+	vb->n = n;
+	// the items may have changed completely, so rebind everything
+	for (i = 0; i < vb->slots->len; i++)
+		slot(vb, i)->index = -1;
+	update(vb);
+}
+
+void uiVirtualBoxItemChanged(uiVirtualBox *vb, int index)
+{
+	struct slot *s;
+	guint i;
+
+	if (index < 0 || index >= vb->n)
+		uiprivUserBug("Item index %d out of range in uiVirtualBoxItemChanged(). (virtual box: %p)", index, vb);
+	for (i = 0; i < vb->slots->len; i++) {
+		s = slot(vb, i);
+		if (s->index == index) {
+			(*(vb->h->BindItem))(vb->h, vb, s->c, index);
+			return;
+		}
+	}
+	// not visible; it'll be bound when it is
+}
+
+void uiVirtualBoxScrollTo(uiVirtualBox *vb, int index)
+{
+	if (index < 0 || index >= vb->n)
+		uiprivUserBug("Item index %d out of range in uiVirtualBoxScrollTo(). (virtual box: %p)", index, vb);
+	// GtkAdjustment clamps this for us; value-changed does the rest
+	gtk_adjustment_set_value(vb->vadj, (double) index * vb->itemHeight);
+}
+
+uiVirtualBox *uiNewVirtualBox(uiVirtualBoxHandler *h, int itemHeight)
+{
+	uiVirtualBox *vb;
+
+	uiUnixNewControl(uiVirtualBox, vb);
+
+	vb->h = h;
+	vb->itemHeight = itemHeight;
+	vb->slots = g_array_new(FALSE, TRUE, sizeof (struct slot));
+
+	vb->widget = gtk_scrolled_window_new(NULL, NULL);
+	vb->scontainer = GTK_CONTAINER(vb->widget);
+	vb->sw = GTK_SCROLLED_WINDOW(vb->widget);
+	// items are always as wide as the box
+	gtk_scrolled_window_set_policy(vb->sw, GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+
+	vb->layoutWidget = gtk_layout_new(NULL, NULL);
+	vb->lcontainer = GTK_CONTAINER(vb->layoutWidget);
+	vb->layout = GTK_LAYOUT(vb->layoutWidget);
+	gtk_container_add(vb->scontainer, vb->layoutWidget);
+	// and make the layout visible; only the scrolled window's visibility is controlled by libui
+	gtk_widget_show(vb->layoutWidget);
+
+	vb->vadj = gtk_scrollable_get_vadjustment(GTK_SCROLLABLE(vb->layoutWidget));
+	g_signal_connect(vb->vadj, "value-changed", G_CALLBACK(onValueChanged), vb);
+	g_signal_connect(vb->layoutWidget, "size-allocate", G_CALLBACK(onSizeAllocate), vb);
+
+	return vb;
+}
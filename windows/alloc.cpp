@@ -16,6 +16,7 @@ void uninitAlloc(void)
 	std::ostringstream oss;
 	std::string ossstr;		// keep alive, just to be safe
 
+	uiprivUninitAllocStats();
 	if (heap.size() == 0)
 		return;
 	for (const auto &alloc : heap)
@@ -34,6 +35,7 @@ void *uiprivAlloc(size_t size, const char *type)
 	out = new byteArray(size, 0);
 	heap[rawBytes(out)] = out;
 	types[out] = type;
+	uiprivAllocStatsAlloc(type, size);
 	return rawBytes(out);
 }
 
@@ -45,6 +47,7 @@ void *uiprivRealloc(void *_p, size_t size, const char *type)
 	if (p == NULL)
 		return uiprivAlloc(size, type);
 	arr = heap[p];
+	uiprivAllocStatsRealloc(types[arr], arr->size(), size);
 	// TODO does this fill in?
 	arr->resize(size, 0);
 	heap.erase(p);
@@ -58,6 +61,7 @@ void uiprivFree(void *_p)
 
 	if (p == NULL)
 		uiprivImplBug("attempt to uiprivFree(NULL)");
+	uiprivAllocStatsFree(types[heap[p]], heap[p]->size());
 	types.erase(heap[p]);
 	delete heap[p];
 	heap.erase(p);
@@ -318,3 +318,32 @@ uiBox *uiNewVerticalBox(void)
 {
 	return finishNewBox(1);
 }
+
+// TODO uiVirtualBox is not implemented on Windows yet; the GTK+ version is in unix/virtualbox.c
+
+int uiVirtualBoxNumItems(uiVirtualBox *vb)
+{
+	uiprivImplBug("uiVirtualBoxNumItems() is not implemented on Windows yet");
+	return 0;
+}
+
+void uiVirtualBoxSetNumItems(uiVirtualBox *vb, int n)
+{
+	uiprivImplBug("uiVirtualBoxSetNumItems() is not implemented on Windows yet");
+}
+
+void uiVirtualBoxItemChanged(uiVirtualBox *vb, int index)
+{
+	uiprivImplBug("uiVirtualBoxItemChanged() is not implemented on Windows yet");
+}
+
+void uiVirtualBoxScrollTo(uiVirtualBox *vb, int index)
+{
+	uiprivImplBug("uiVirtualBoxScrollTo() is not implemented on Windows yet");
+}
+
+uiVirtualBox *uiNewVirtualBox(uiVirtualBoxHandler *h, int itemHeight)
+{
+	uiprivImplBug("uiNewVirtualBox() is not implemented on Windows yet");
+	return NULL;
+}
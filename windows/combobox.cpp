@@ -108,3 +108,15 @@ uiCombobox *uiNewCombobox(void)
 
 	return c;
 }
+
+// TODO not implemented on Windows yet; the GTK+ version is in unix/combobox.c
+
+void uiComboboxSetItems(uiCombobox *c, const char *const *items, int n)
+{
+	uiprivImplBug("uiComboboxSetItems() is not implemented on Windows yet");
+}
+
+void uiComboboxSetVirtualItems(uiCombobox *c, int n, const char *(*item)(uiCombobox *c, int i, void *data), void *data)
+{
+	uiprivImplBug("uiComboboxSetVirtualItems() is not implemented on Windows yet");
+}
@@ -119,3 +119,46 @@ void uiWindowsControlNotifyVisibilityChanged(uiWindowsControl *c)
 	// TODO we really need to figure this out; the duplication is a mess
 	uiWindowsControlContinueMinimumSizeChanged(c);
 }
+
+// the nesting depth lives in a window property, so it goes away with the window
+// WM_SETREDRAW TRUE also makes a hidden window visible, so only windows that are visible when the update starts are frozen; the low bit of the property says whether this one was
+static const WCHAR updateProp[] = L"libui-update";
+
+void uiControlBeginUpdate(uiControl *c)
+{
+	HWND hwnd;
+	uintptr_t state;
+
+	hwnd = (HWND) uiControlHandle(c);
+	state = (uintptr_t) GetPropW(hwnd, updateProp);
+	if (state == 0 && IsWindowVisible(hwnd)) {
+		SendMessageW(hwnd, WM_SETREDRAW, (WPARAM) FALSE, 0);
+		state = 1;
+	}
+	state += 2;
+	if (SetPropW(hwnd, updateProp, (HANDLE) state) == 0)
+		logLastError(L"error setting update state");
+}
+
+void uiControlEndUpdate(uiControl *c)
+{
+	HWND hwnd;
+	uintptr_t state;
+
+	hwnd = (HWND) uiControlHandle(c);
+	state = (uintptr_t) GetPropW(hwnd, updateProp);
+	if (state < 2)
+		uiprivUserBug("You cannot call uiControlEndUpdate() without a matching uiControlBeginUpdate(). (control: %p)", c);
+	state -= 2;
+	if (state >= 2) {
+		if (SetPropW(hwnd, updateProp, (HANDLE) state) == 0)
+			logLastError(L"error setting update state");
+		return;
+	}
+	RemovePropW(hwnd, updateProp);
+	if (state == 1) {
+		SendMessageW(hwnd, WM_SETREDRAW, (WPARAM) TRUE, 0);
+		if (RedrawWindow(hwnd, NULL, NULL, RDW_ERASE | RDW_FRAME | RDW_INVALIDATE | RDW_ALLCHILDREN) == 0)
+			logLastError(L"error redrawing control after update");
+	}
+}
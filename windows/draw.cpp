@@ -509,3 +509,45 @@ void uiDrawRestore(uiDrawContext *c)
 	// no need to explicitly addref or release; just transfer the ref
 	c->currentClip = state.clip;
 }
+
+// TODO not implemented on Windows yet; the GTK+ versions are in unix/drawoffscreen.c
+
+uiDrawContext *uiDrawNewImageContext(int pixelWidth, int pixelHeight)
+{
+	uiprivImplBug("uiDrawNewImageContext() is not implemented on Windows yet");
+	return NULL;
+}
+
+uiDrawContext *uiDrawNewPDFContext(const char *filename, double width, double height)
+{
+	uiprivImplBug("uiDrawNewPDFContext() is not implemented on Windows yet");
+	return NULL;
+}
+
+uiDrawContext *uiDrawNewSVGContext(const char *filename, double width, double height)
+{
+	uiprivImplBug("uiDrawNewSVGContext() is not implemented on Windows yet");
+	return NULL;
+}
+
+void uiDrawContextNewPage(uiDrawContext *c)
+{
+	uiprivImplBug("uiDrawContextNewPage() is not implemented on Windows yet");
+}
+
+const void *uiDrawContextPixels(uiDrawContext *c, int *byteStride)
+{
+	uiprivImplBug("uiDrawContextPixels() is not implemented on Windows yet");
+	return NULL;
+}
+
+int uiDrawContextWritePNG(uiDrawContext *c, const char *filename)
+{
+	uiprivImplBug("uiDrawContextWritePNG() is not implemented on Windows yet");
+	return 0;
+}
+
+void uiDrawFreeContext(uiDrawContext *c)
+{
+	uiprivImplBug("uiDrawFreeContext() is not implemented on Windows yet");
+}
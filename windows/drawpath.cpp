@@ -46,6 +46,20 @@ void uiDrawFreePath(uiDrawPath *p)
 	uiprivFree(p);
 }
 
+// single precision is only a way to save memory, so a regular path is a fine substitute
+uiDrawPath *uiDrawNewSinglePrecisionPath(uiDrawFillMode fillMode)
+{
+	return uiDrawNewPath(fillMode);
+}
+
+// this is only a hint; ID2D1GeometrySink doesn't let us preallocate
+void uiDrawPathReserve(uiDrawPath *p, size_t n)
+{
+	// the sink goes away when the path is ended
+	if (p->sink == NULL)
+		uiprivUserBug("You cannot call uiDrawPathReserve() on a uiDrawPath that has already been ended. (path: %p)", p);
+}
+
 void uiDrawPathNewFigure(uiDrawPath *p, double x, double y)
 {
 	D2D1_POINT_2F pt;
@@ -245,3 +259,11 @@ ID2D1PathGeometry *pathGeometry(uiDrawPath *p)
 		uiprivUserBug("You cannot draw with a uiDrawPath that was not ended. (path: %p)", p);
 	return p->path;
 }
+
+// TODO not implemented on Windows yet; the GTK+ version is in unix/drawpath.c
+
+uiDrawPath *uiDrawNewFramePath(uiDrawContext *c, uiDrawFillMode fillMode)
+{
+	uiprivImplBug("uiDrawNewFramePath() is not implemented on Windows yet");
+	return NULL;
+}
@@ -534,3 +534,75 @@ void uiDrawTextLayoutExtents(uiDrawTextLayout *tl, double *width, double *height
 	// TODO make sure the behavior of this on empty strings is the same on all platforms (ideally should be 0-width, line height-height; TODO note this in the docs too)
 	*height = metrics.height;
 }
+
+// TODO not implemented on Windows yet; the GTK+ versions are in unix/drawtext.c and unix/drawglyphs.c
+
+int uiDrawTextLayoutNumLines(uiDrawTextLayout *tl)
+{
+	uiprivImplBug("uiDrawTextLayoutNumLines() is not implemented on Windows yet");
+	return 0;
+}
+
+void uiDrawTextLayoutLineByteRange(uiDrawTextLayout *tl, int line, size_t *start, size_t *end)
+{
+	uiprivImplBug("uiDrawTextLayoutLineByteRange() is not implemented on Windows yet");
+}
+
+void uiDrawTextLayoutLineGetMetrics(uiDrawTextLayout *tl, int line, uiDrawTextLayoutLineMetrics *m)
+{
+	uiprivImplBug("uiDrawTextLayoutLineGetMetrics() is not implemented on Windows yet");
+}
+
+int uiDrawTextLayoutLineForByte(uiDrawTextLayout *tl, size_t pos)
+{
+	uiprivImplBug("uiDrawTextLayoutLineForByte() is not implemented on Windows yet");
+	return 0;
+}
+
+double uiDrawTextLayoutByteLocationInLine(uiDrawTextLayout *tl, size_t pos, int line)
+{
+	uiprivImplBug("uiDrawTextLayoutByteLocationInLine() is not implemented on Windows yet");
+	return 0;
+}
+
+void uiDrawTextLayoutHitTest(uiDrawTextLayout *tl, double x, double y, size_t *pos, int *line)
+{
+	uiprivImplBug("uiDrawTextLayoutHitTest() is not implemented on Windows yet");
+}
+
+void uiDrawTextLayoutForEachRangeRect(uiDrawTextLayout *tl, size_t start, size_t end, uiDrawTextLayoutRangeRectFunc f, void *data)
+{
+	uiprivImplBug("uiDrawTextLayoutForEachRangeRect() is not implemented on Windows yet");
+}
+
+uiDrawTextLayoutTask *uiDrawNewTextLayoutAsync(uiDrawTextLayoutParams *params, uiDrawTextLayoutTaskFunc f, void *data)
+{
+	uiprivImplBug("uiDrawNewTextLayoutAsync() is not implemented on Windows yet");
+	return NULL;
+}
+
+void uiDrawTextLayoutTaskCancel(uiDrawTextLayoutTask *task)
+{
+	uiprivImplBug("uiDrawTextLayoutTaskCancel() is not implemented on Windows yet");
+}
+
+uiDrawGlyphFont *uiDrawNewGlyphFont(const uiFontDescriptor *desc)
+{
+	uiprivImplBug("uiDrawNewGlyphFont() is not implemented on Windows yet");
+	return NULL;
+}
+
+void uiDrawFreeGlyphFont(uiDrawGlyphFont *f)
+{
+	uiprivImplBug("uiDrawFreeGlyphFont() is not implemented on Windows yet");
+}
+
+void uiDrawGlyphFontExtents(uiDrawGlyphFont *f, const char *text, double *width, double *height)
+{
+	uiprivImplBug("uiDrawGlyphFontExtents() is not implemented on Windows yet");
+}
+
+void uiDrawGlyphRuns(uiDrawContext *c, uiDrawGlyphFont *f, const uiDrawGlyphRun *runs, size_t n, uiDrawBrush *b)
+{
+	uiprivImplBug("uiDrawGlyphRuns() is not implemented on Windows yet");
+}
@@ -7,6 +7,7 @@ struct uiEntry {
 	void (*onChanged)(uiEntry *, void *);
 	void *onChangedData;
 	BOOL inhibitChanged;
+	uiprivThrottle *throttle;
 };
 
 static BOOL onWM_COMMAND(uiControl *c, HWND hwnd, WORD code, LRESULT *lResult)
@@ -17,16 +18,24 @@ static BOOL onWM_COMMAND(uiControl *c, HWND hwnd, WORD code, LRESULT *lResult)
 		return FALSE;
 	if (e->inhibitChanged)
 		return FALSE;
-	(*(e->onChanged))(e, e->onChangedData);
+	uiprivThrottleNotify(e->throttle);
 	*lResult = 0;
 	return TRUE;
 }
 
+static void fireChanged(void *data)
+{
+	uiEntry *e = uiEntry(data);
+
+	(*(e->onChanged))(e, e->onChangedData);
+}
+
 static void uiEntryDestroy(uiControl *c)
 {
 	uiEntry *e = uiEntry(c);
 
 	uiWindowsUnregisterWM_COMMANDHandler(e->hwnd);
+	uiprivFreeThrottle(e->throttle);
 	uiWindowsEnsureDestroyWindow(e->hwnd);
 	uiFreeControl(uiControl(e));
 }
@@ -76,6 +85,11 @@ void uiEntryOnChanged(uiEntry *e, void (*f)(uiEntry *, void *), void *data)
 	e->onChangedData = data;
 }
 
+void uiEntrySetChangePolicy(uiEntry *e, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(e->throttle, policy, milliseconds);
+}
+
 int uiEntryReadOnly(uiEntry *e)
 {
 	return (getStyle(e->hwnd) & ES_READONLY) != 0;
@@ -104,6 +118,7 @@ static uiEntry *finishNewEntry(DWORD style)
 		hInstance, NULL,
 		TRUE);
 
+	e->throttle = uiprivNewThrottle(fireChanged, e);
 	uiWindowsRegisterWM_COMMANDHandler(e->hwnd, onWM_COMMAND, uiControl(e));
 	uiEntryOnChanged(e, defaultOnChanged, NULL);
 
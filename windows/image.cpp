@@ -224,3 +224,53 @@ fail:
 	src->Release();
 	return hr;
 }
+
+// uiImageAppend() copies the pixels into a WIC bitmap anyway, so any stride works as well as any other
+int uiImagePreferredByteStride(int pixelWidth)
+{
+	return pixelWidth * 4;
+}
+
+// TODO not implemented on Windows yet; the GTK+ versions are in unix/image.c and unix/pixelbuffer.c
+
+void uiImageAppendPremultiplied(uiImage *i, void *pixels, int pixelWidth, int pixelHeight, int byteStride)
+{
+	uiprivImplBug("uiImageAppendPremultiplied() is not implemented on Windows yet");
+}
+
+void uiImageAppendBorrowed(uiImage *i, void *pixels, int pixelWidth, int pixelHeight, int byteStride, void (*destroy)(void *pixels, void *data), void *data)
+{
+	uiprivImplBug("uiImageAppendBorrowed() is not implemented on Windows yet");
+}
+
+void uiDrawImage(uiDrawContext *c, uiImage *img, double x, double y, double width, double height, uiDrawImageFilter filter)
+{
+	uiprivImplBug("uiDrawImage() is not implemented on Windows yet");
+}
+
+uiPixelBuffer *uiNewPixelBuffer(int pixelWidth, int pixelHeight)
+{
+	uiprivImplBug("uiNewPixelBuffer() is not implemented on Windows yet");
+	return NULL;
+}
+
+void uiFreePixelBuffer(uiPixelBuffer *pb)
+{
+	uiprivImplBug("uiFreePixelBuffer() is not implemented on Windows yet");
+}
+
+void *uiPixelBufferMap(uiPixelBuffer *pb, int *byteStride)
+{
+	uiprivImplBug("uiPixelBufferMap() is not implemented on Windows yet");
+	return NULL;
+}
+
+void uiPixelBufferUnmap(uiPixelBuffer *pb, int x, int y, int width, int height)
+{
+	uiprivImplBug("uiPixelBufferUnmap() is not implemented on Windows yet");
+}
+
+void uiDrawPixelBuffer(uiDrawContext *c, uiPixelBuffer *pb, double x, double y, double width, double height, uiDrawImageFilter filter)
+{
+	uiprivImplBug("uiDrawPixelBuffer() is not implemented on Windows yet");
+}
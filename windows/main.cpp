@@ -158,3 +158,29 @@ void uiprivUninitTimers(void)
 		uiprivFree(t->first);
 	timers.clear();
 }
+
+// documented in ui.h: there is no file descriptor to give out here
+int uiMainGetPollFD(void)
+{
+	return -1;
+}
+
+// TODO not implemented on Windows yet; the GTK+ versions are in unix/main.c
+
+const char *uiInitHeadless(uiInitOptions *options)
+{
+	uiprivImplBug("uiInitHeadless() is not implemented on Windows yet");
+	return NULL;
+}
+
+int uiMainPrepare(void)
+{
+	uiprivImplBug("uiMainPrepare() is not implemented on Windows yet");
+	return 0;
+}
+
+int uiMainDispatch(int budgetMilliseconds)
+{
+	uiprivImplBug("uiMainDispatch() is not implemented on Windows yet");
+	return 0;
+}
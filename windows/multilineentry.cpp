@@ -9,6 +9,7 @@ struct uiMultilineEntry {
 	void (*onChanged)(uiMultilineEntry *, void *);
 	void *onChangedData;
 	BOOL inhibitChanged;
+	uiprivThrottle *throttle;
 };
 
 static BOOL onWM_COMMAND(uiControl *c, HWND hwnd, WORD code, LRESULT *lResult)
@@ -19,16 +20,24 @@ static BOOL onWM_COMMAND(uiControl *c, HWND hwnd, WORD code, LRESULT *lResult)
 		return FALSE;
 	if (e->inhibitChanged)
 		return FALSE;
-	(*(e->onChanged))(e, e->onChangedData);
+	uiprivThrottleNotify(e->throttle);
 	*lResult = 0;
 	return TRUE;
 }
 
+static void fireChanged(void *data)
+{
+	uiMultilineEntry *e = uiMultilineEntry(data);
+
+	(*(e->onChanged))(e, e->onChangedData);
+}
+
 static void uiMultilineEntryDestroy(uiControl *c)
 {
 	uiMultilineEntry *e = uiMultilineEntry(c);
 
 	uiWindowsUnregisterWM_COMMANDHandler(e->hwnd);
+	uiprivFreeThrottle(e->throttle);
 	uiWindowsEnsureDestroyWindow(e->hwnd);
 	uiFreeControl(uiControl(e));
 }
@@ -107,6 +116,11 @@ void uiMultilineEntryOnChanged(uiMultilineEntry *e, void (*f)(uiMultilineEntry *
 	e->onChangedData = data;
 }
 
+void uiMultilineEntrySetChangePolicy(uiMultilineEntry *e, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(e->throttle, policy, milliseconds);
+}
+
 int uiMultilineEntryReadOnly(uiMultilineEntry *e)
 {
 	return (getStyle(e->hwnd) & ES_READONLY) != 0;
@@ -135,6 +149,7 @@ static uiMultilineEntry *finishMultilineEntry(DWORD style)
 		hInstance, NULL,
 		TRUE);
 
+	e->throttle = uiprivNewThrottle(fireChanged, e);
 	uiWindowsRegisterWM_COMMANDHandler(e->hwnd, onWM_COMMAND, uiControl(e));
 	uiMultilineEntryOnChanged(e, defaultOnChanged, NULL);
 
@@ -150,3 +165,28 @@ uiMultilineEntry *uiNewNonWrappingMultilineEntry(void)
 {
 	return finishMultilineEntry(WS_HSCROLL | ES_AUTOHSCROLL);
 }
+
+// TODO not implemented on Windows yet; the GTK+ versions are in unix/multilineentry.c
+
+int uiMultilineEntryNumLines(uiMultilineEntry *e)
+{
+	uiprivImplBug("uiMultilineEntryNumLines() is not implemented on Windows yet");
+	return 0;
+}
+
+char *uiMultilineEntryTextRange(uiMultilineEntry *e, int firstLine, int nLines)
+{
+	uiprivImplBug("uiMultilineEntryTextRange() is not implemented on Windows yet");
+	return NULL;
+}
+
+int uiMultilineEntryMaxLines(uiMultilineEntry *e)
+{
+	uiprivImplBug("uiMultilineEntryMaxLines() is not implemented on Windows yet");
+	return 0;
+}
+
+void uiMultilineEntrySetMaxLines(uiMultilineEntry *e, int maxLines)
+{
+	uiprivImplBug("uiMultilineEntrySetMaxLines() is not implemented on Windows yet");
+}
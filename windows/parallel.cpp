@@ -0,0 +1,62 @@
+// 19 october 2026
+#include "uipriv_windows.hpp"
+
+// the calling thread works too, so this is the most extra threads we'll start
+#define maxThreads 64
+
+struct parallel {
+	uiprivParallelFunc f;
+	void *data;
+	LONG n;
+	volatile LONG next;
+};
+
+static DWORD WINAPI worker(LPVOID data)
+{
+	struct parallel *p = (struct parallel *) data;
+	LONG i;
+
+	for (;;) {
+		i = InterlockedIncrement(&(p->next)) - 1;
+		if (i >= p->n)
+			break;
+		(*(p->f))(p->data, (size_t) i);
+	}
+	return 0;
+}
+
+void uiprivParallelFor(size_t n, uiprivParallelFunc f, void *data)
+{
+	struct parallel p;
+	HANDLE threads[maxThreads];
+	SYSTEM_INFO si;
+	DWORD i, nThreads;
+
+	if (n == 0)
+		return;
+	if (n > MAXLONG)
+		uiprivImplBug("too many work items passed to uiprivParallelFor()");
+	p.f = f;
+	p.data = data;
+	p.n = (LONG) n;
+	p.next = 0;
+	GetSystemInfo(&si);
+	nThreads = si.dwNumberOfProcessors - 1;
+	if (nThreads > (DWORD) (p.n - 1))
+		nThreads = (DWORD) (p.n - 1);
+	if (nThreads > maxThreads)
+		nThreads = maxThreads;
+	for (i = 0; i < nThreads; i++) {
+		threads[i] = CreateThread(NULL, 0, worker, &p, 0, NULL);
+		if (threads[i] == NULL) {
+			// just make do with the threads we have; the calling thread alone is enough to finish
+			nThreads = i;
+			break;
+		}
+	}
+	worker(&p);
+	if (nThreads != 0)
+		WaitForMultipleObjects(nThreads, threads, TRUE, INFINITE);
+	for (i = 0; i < nThreads; i++)
+		CloseHandle(threads[i]);
+}
@@ -194,3 +194,10 @@ uiRadioButtons *uiNewRadioButtons(void)
 
 	return r;
 }
+
+// TODO not implemented on Windows yet; the GTK+ version is in unix/radiobuttons.c
+
+void uiRadioButtonsSetItems(uiRadioButtons *r, const char *const *items, int n)
+{
+	uiprivImplBug("uiRadioButtonsSetItems() is not implemented on Windows yet");
+}
@@ -6,22 +6,31 @@ struct uiSlider {
 	HWND hwnd;
 	void (*onChanged)(uiSlider *, void *);
 	void *onChangedData;
+	uiprivThrottle *throttle;
 };
 
 static BOOL onWM_HSCROLL(uiControl *c, HWND hwnd, WORD code, LRESULT *lResult)
 {
 	uiSlider *s = uiSlider(c);
 
-	(*(s->onChanged))(s, s->onChangedData);
+	uiprivThrottleNotify(s->throttle);
 	*lResult = 0;
 	return TRUE;
 }
 
+static void fireChanged(void *data)
+{
+	uiSlider *s = uiSlider(data);
+
+	(*(s->onChanged))(s, s->onChangedData);
+}
+
 static void uiSliderDestroy(uiControl *c)
 {
 	uiSlider *s = uiSlider(c);
 
 	uiWindowsUnregisterWM_HSCROLLHandler(s->hwnd);
+	uiprivFreeThrottle(s->throttle);
 	uiWindowsEnsureDestroyWindow(s->hwnd);
 	uiFreeControl(uiControl(s));
 }
@@ -68,6 +77,11 @@ void uiSliderOnChanged(uiSlider *s, void (*f)(uiSlider *, void *), void *data)
 	s->onChangedData = data;
 }
 
+void uiSliderSetChangePolicy(uiSlider *s, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(s->throttle, policy, milliseconds);
+}
+
 uiSlider *uiNewSlider(int min, int max)
 {
 	uiSlider *s;
@@ -87,6 +101,7 @@ uiSlider *uiNewSlider(int min, int max)
 		hInstance, NULL,
 		TRUE);
 
+	s->throttle = uiprivNewThrottle(fireChanged, s);
 	uiWindowsRegisterWM_HSCROLLHandler(s->hwnd, onWM_HSCROLL, uiControl(s));
 	uiSliderOnChanged(s, defaultOnChanged, NULL);
 
@@ -9,6 +9,7 @@ struct uiSpinbox {
 	void (*onChanged)(uiSpinbox *, void *);
 	void *onChangedData;
 	BOOL inhibitChanged;
+	uiprivThrottle *throttle;
 };
 
 // utility functions
@@ -54,15 +55,23 @@ static BOOL onWM_COMMAND(uiControl *c, HWND hwnd, WORD code, LRESULT *lResult)
 	uiprivFree(wtext);
 	// value() does the work for us
 	value(s);
-	(*(s->onChanged))(s, s->onChangedData);
+	uiprivThrottleNotify(s->throttle);
 	return TRUE;
 }
 
+static void fireChanged(void *data)
+{
+	uiSpinbox *s = uiSpinbox(data);
+
+	(*(s->onChanged))(s, s->onChangedData);
+}
+
 static void uiSpinboxDestroy(uiControl *c)
 {
 	uiSpinbox *s = uiSpinbox(c);
 
 	uiWindowsUnregisterWM_COMMANDHandler(s->edit);
+	uiprivFreeThrottle(s->throttle);
 	uiWindowsEnsureDestroyWindow(s->updown);
 	uiWindowsEnsureDestroyWindow(s->edit);
 	uiWindowsEnsureDestroyWindow(s->hwnd);
@@ -175,6 +184,11 @@ void uiSpinboxOnChanged(uiSpinbox *s, void (*f)(uiSpinbox *, void *), void *data
 	s->onChangedData = data;
 }
 
+void uiSpinboxSetChangePolicy(uiSpinbox *s, uiChangePolicy policy, int milliseconds)
+{
+	uiprivThrottleSetPolicy(s->throttle, policy, milliseconds);
+}
+
 static void onResize(uiWindowsControl *c)
 {
 	spinboxRelayout(uiSpinbox(c));
@@ -203,6 +217,7 @@ uiSpinbox *uiNewSpinbox(int min, int max)
 		TRUE);
 	uiWindowsEnsureSetParentHWND(s->edit, s->hwnd);
 
+	s->throttle = uiprivNewThrottle(fireChanged, s);
 	uiWindowsRegisterWM_COMMANDHandler(s->edit, onWM_COMMAND, uiControl(s));
 	uiSpinboxOnChanged(s, defaultOnChanged, NULL);
 